@@ -0,0 +1,72 @@
+#include "boot_profile.h"
+#include "log.h"
+
+BootProfile bootProfile;
+
+static const char* const stageNames[BOOT_STAGE_COUNT] = {
+  "spiffs", "config", "rtc", "display", "web", "wifi", "internet", "ntp", "firstFetch"
+};
+static const char* const stateNames[] = {"pending", "running", "done", "failed", "skipped"};
+
+static void checkSettled() {
+  if (!bootProfile.setupMs) return;
+  for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+    BootStageState state = bootProfile.stages[i].state;
+    if (state == BOOT_PENDING || state == BOOT_RUNNING) return;
+  }
+  if (!bootProfile.settledMs) {
+    bootProfile.settledMs = millis();
+    logBootProfile();
+  }
+}
+
+void bootStageBegin(BootStage stage) {
+  BootStageTiming& timing = bootProfile.stages[stage];
+  timing.startMs = millis();
+  timing.endMs = 0;
+  timing.state = BOOT_RUNNING;
+}
+
+void bootStageEnd(BootStage stage, bool ok) {
+  BootStageTiming& timing = bootProfile.stages[stage];
+  timing.endMs = millis();
+  timing.state = ok ? BOOT_DONE : BOOT_FAILED;
+  LOG_INFO(SYS, "Boot: %s %s after %u ms (at %u ms)\n", stageNames[stage],
+           ok ? "done" : "failed", timing.endMs - timing.startMs, timing.endMs);
+  checkSettled();
+}
+
+void bootStageSkip(BootStage stage) {
+  BootStageTiming& timing = bootProfile.stages[stage];
+  if (timing.state != BOOT_PENDING) return;
+  timing.startMs = timing.endMs = millis();
+  timing.state = BOOT_SKIPPED;
+  checkSettled();
+}
+
+void bootSetupDone() {
+  bootProfile.setupMs = millis();
+  bootProfile.heapAfterSetup = ESP.getFreeHeap();
+  LOG_INFO(SYS, "Boot: setup done at %u ms, panel lit at %u ms, %u bytes free\n",
+           bootProfile.setupMs, bootProfile.stages[BOOT_DISPLAY].endMs, bootProfile.heapAfterSetup);
+  checkSettled();
+}
+
+void logBootProfile() {
+  LOG_INFO(SYS, "Boot profile (ms since power-on):\n");
+  for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+    const BootStageTiming& timing = bootProfile.stages[i];
+    LOG_INFO(SYS, "  %-10s %-7s start %6u  took %6u\n", stageNames[i], stateNames[timing.state],
+             timing.startMs, timing.endMs - timing.startMs);
+  }
+  LOG_INFO(SYS, "  setup returned at %u, all stages settled at %u\n",
+           bootProfile.setupMs, bootProfile.settledMs);
+}
+
+const char* bootStageName(BootStage stage) {
+  return stage < BOOT_STAGE_COUNT ? stageNames[stage] : "?";
+}
+
+const char* bootStageStateName(BootStageState state) {
+  return state <= BOOT_SKIPPED ? stateNames[state] : "?";
+}
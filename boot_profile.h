@@ -0,0 +1,62 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+// Startup stage timing.
+//
+// setup() brings up flash, config, the clock from the RTC, the panel and
+// the web server, then returns. Wi-Fi, the internet probe, NTP and the
+// first feed fetch continue on the network startup task (see
+// wifi_manager) while the panel already shows the clock and the stored
+// scroll contents. Each stage records when it started and finished,
+// in millis() since boot, for /status and the serial log.
+
+enum BootStage : uint8_t {
+  BOOT_SPIFFS = 0,
+  BOOT_CONFIG,
+  BOOT_RTC,
+  BOOT_DISPLAY,
+  BOOT_WEB,
+  BOOT_WIFI,
+  BOOT_INTERNET,
+  BOOT_NTP,
+  BOOT_FIRST_FETCH,
+  BOOT_STAGE_COUNT
+};
+
+enum BootStageState : uint8_t {
+  BOOT_PENDING = 0,
+  BOOT_RUNNING,
+  BOOT_DONE,
+  BOOT_FAILED,
+  BOOT_SKIPPED   // not reached, e.g. NTP without internet
+};
+
+struct BootStageTiming {
+  uint32_t startMs;
+  uint32_t endMs;
+  BootStageState state;
+};
+
+struct BootProfile {
+  BootStageTiming stages[BOOT_STAGE_COUNT];
+  uint32_t setupMs;     // setup() returned
+  uint32_t settledMs;   // every stage finished; 0 while some still run
+  uint32_t heapAfterSetup;
+};
+
+extern BootProfile bootProfile;
+
+void bootStageBegin(BootStage stage);
+void bootStageEnd(BootStage stage, bool ok);
+void bootStageSkip(BootStage stage);  // if it has not started
+void bootSetupDone();
+
+// Logs the table once the last stage has finished
+void logBootProfile();
+
+const char* bootStageName(BootStage stage);
+const char* bootStageStateName(BootStageState state);
+
+#endif
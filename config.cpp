@@ -1,9 +1,8 @@
 
 #include "config.h"
-
-// File paths
-const char* CONFIG_PATH = "/feeds.json";
-const char* SETTINGS_PATH = "/settings.json";
+#include "rss_filter.h"
+#include "config_store.h"
+#include "log.h"
 
 // Default RSS feeds
 const std::vector<RSSFeed> DEFAULT_FEEDS = {
@@ -14,35 +13,89 @@ const std::vector<RSSFeed> DEFAULT_FEEDS = {
   {"Reuters", "https://feeds.reuters.com/reuters/topNews", true}
 };
 
+static SemaphoreHandle_t feedsMutex = xSemaphoreCreateMutex();
+static SemaphoreHandle_t settingsMutex = xSemaphoreCreateMutex();
+
+// Ids are never handed out twice while running, so a stale id from an
+// open web page can't hit a different feed
+static uint16_t nextFeedId = 1;
+volatile uint32_t feedListVersion = 0;
+
+void lockFeeds() {
+  xSemaphoreTake(feedsMutex, portMAX_DELAY);
+}
+
+bool tryLockFeeds() {
+  return xSemaphoreTake(feedsMutex, 0) == pdTRUE;
+}
+
+void unlockFeeds() {
+  xSemaphoreGive(feedsMutex);
+}
+
+void lockSettings() {
+  xSemaphoreTake(settingsMutex, portMAX_DELAY);
+}
+
+void unlockSettings() {
+  xSemaphoreGive(settingsMutex);
+}
+
+uint16_t assignFeedId() {
+  // Ids wrap, and clients may send any id, so skip the ones in use along
+  // with 0 (unassigned) and UINT16_MAX (no feed)
+  for (;;) {
+    uint16_t id = nextFeedId++;
+    if (id != 0 && id != UINT16_MAX && findFeedIndex(id) < 0) return id;
+  }
+}
+
+int findFeedIndex(uint16_t id) {
+  for (size_t i = 0; i < feeds.size(); i++) {
+    if (feeds[i].id == id) return i;
+  }
+  return -1;
+}
+
+void normalizeFeedIds() {
+  for (const auto& feed : feeds) {
+    if (feed.id >= nextFeedId && feed.id != UINT16_MAX) nextFeedId = feed.id + 1;
+  }
+  for (size_t i = 0; i < feeds.size(); i++) {
+    bool repeated = false;
+    for (size_t j = 0; j < i && !repeated; j++) {
+      repeated = feeds[j].id == feeds[i].id;
+    }
+    if (feeds[i].id == 0 || feeds[i].id == UINT16_MAX || repeated) {
+      feeds[i].id = assignFeedId();
+    }
+  }
+}
+
 bool initializeSPIFFS() {
   if (!SPIFFS.begin(true)) {
-    Serial.println("SPIFFS Mount Failed");
+    LOG_ERROR(SYS, "SPIFFS Mount Failed\n");
     return false;
   }
   
-  Serial.println("SPIFFS initialized successfully");
+  LOG_INFO(SYS, "SPIFFS initialized successfully\n");
   
   // Check available space
   size_t totalBytes = SPIFFS.totalBytes();
   size_t usedBytes = SPIFFS.usedBytes();
-  Serial.printf("SPIFFS: %d/%d bytes used\n", usedBytes, totalBytes);
+  LOG_INFO(SYS, "SPIFFS: %d/%d bytes used\n", usedBytes, totalBytes);
   
   return true;
 }
 
-bool loadFeedsFromFile() {
-  File file = SPIFFS.open(CONFIG_PATH, "r");
-  if (!file) {
-    Serial.println("Feeds config file not found - will use defaults");
-    return false;
-  }
-  
+// Reads /feeds.json from before the binary format
+static bool importFeedsConfig(char* data, size_t len) {
+  // Parsed in place, so the document holds no copies of the strings
   DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-  DeserializationError error = deserializeJson(doc, file);
-  file.close();
+  DeserializationError error = deserializeJson(doc, data, len);
   
   if (error) {
-    Serial.printf("Failed to parse feeds config: %s\n", error.c_str());
+    LOG_ERROR(SYS, "Failed to parse feeds config: %s\n", error.c_str());
     return false;
   }
   
@@ -51,53 +104,75 @@ bool loadFeedsFromFile() {
   
   for (JsonObject obj : array) {
     RSSFeed feed;
+    feed.id = obj["id"] | 0;
     feed.name = obj["name"].as<String>();
     feed.url = obj["url"].as<String>();
     feed.enabled = obj["enabled"].as<bool>();
     feeds.push_back(feed);
   }
+  // Files written before feed ids existed get them here
+  normalizeFeedIds();
   
-  Serial.printf("Loaded %d RSS feeds from config\n", feeds.size());
+  LOG_INFO(SYS, "Loaded %d RSS feeds from config\n", feeds.size());
   return true;
 }
 
-bool saveFeedsToFile() {
-  File file = SPIFFS.open(CONFIG_PATH, "w");
-  if (!file) {
-    Serial.println("Failed to open feeds config for writing");
-    return false;
-  }
-  
-  DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-  JsonArray array = doc.to<JsonArray>();
+static bool decodeFeedsConfig(ConfigReader& in) {
+  uint16_t count = in.u16();
+  std::vector<RSSFeed> loaded;
+  loaded.reserve(count);
   
-  for (const auto& feed : feeds) {
-    JsonObject obj = array.createNestedObject();
-    obj["name"] = feed.name;
-    obj["url"] = feed.url;
-    obj["enabled"] = feed.enabled;
+  for (uint16_t i = 0; i < count && !in.failed(); i++) {
+    RSSFeed feed;
+    feed.id = in.u16();
+    feed.enabled = in.u8();
+    in.str(feed.name);
+    in.str(feed.url);
+    loaded.push_back(feed);
   }
+  if (in.failed()) return false;
   
-  size_t bytesWritten = serializeJson(doc, file);
-  file.close();
-  
-  Serial.printf("Saved %d feeds to config (%d bytes)\n", feeds.size(), bytesWritten);
-  return bytesWritten > 0;
+  feeds.swap(loaded);
+  normalizeFeedIds();
+  LOG_INFO(SYS, "Loaded %d RSS feeds from config\n", feeds.size());
+  return true;
 }
 
-bool loadSettings() {
-  File file = SPIFFS.open(SETTINGS_PATH, "r");
-  if (!file) {
-    Serial.println("Settings file not found - using defaults");
+bool loadFeedsFromFile() {
+  if (!loadConfigFile(CONFIG_FEEDS, decodeFeedsConfig, importFeedsConfig)) {
+    LOG_WARN(SYS, "Feeds config file not found - will use defaults\n");
     return false;
   }
+  return true;
+}
+
+void encodeFeedsConfig(ConfigWriter& out) {
+  // Web edits may run while this writes, so work from a snapshot
+  lockFeeds();
+  std::vector<RSSFeed> snapshot = feeds;
+  unlockFeeds();
   
+  out.u16(snapshot.size());
+  for (const RSSFeed& feed : snapshot) {
+    out.u16(feed.id);
+    out.u8(feed.enabled);
+    out.str(feed.name);
+    out.str(feed.url);
+  }
+}
+
+bool saveFeedsToFile() {
+  markConfigDirty(CONFIG_FEEDS);
+  return true;
+}
+
+// Reads /settings.json from before the binary format
+static bool importSettingsConfig(char* data, size_t len) {
   DynamicJsonDocument doc(1024);
-  DeserializationError error = deserializeJson(doc, file);
-  file.close();
+  DeserializationError error = deserializeJson(doc, data, len);
   
   if (error) {
-    Serial.printf("Failed to parse settings: %s\n", error.c_str());
+    LOG_ERROR(SYS, "Failed to parse settings: %s\n", error.c_str());
     return false;
   }
   
@@ -105,51 +180,82 @@ bool loadSettings() {
   settings.maxNewsAgeHours = doc["maxNewsAgeHours"] | 24;
   settings.tzRegion = doc["tzRegion"] | "Asia/Kolkata";
   settings.maxHeadlinesPerFeed = doc["maxHeadlinesPerFeed"] | MAX_HEADLINES_PER_FEED;
+  settings.interleaveFeeds = doc["interleaveFeeds"] | false;
+  settings.blockKeywords = doc["blockKeywords"] | "";
+  settings.boostKeywords = doc["boostKeywords"] | "";
   
-  Serial.println("Settings loaded successfully");
+  LOG_INFO(SYS, "Settings loaded successfully\n");
   return true;
 }
 
-bool saveSettings() {
-  File file = SPIFFS.open(SETTINGS_PATH, "w");
-  if (!file) {
-    Serial.println("Failed to open settings file for writing");
+static bool decodeSettingsConfig(ConfigReader& in) {
+  // Decoded aside, so a rejected copy leaves the defaults alone
+  Settings loaded = settings;
+  loaded.fetchInterval = in.u32();
+  loaded.maxNewsAgeHours = in.u32();
+  loaded.maxHeadlinesPerFeed = in.u16();
+  loaded.interleaveFeeds = in.u8();
+  in.str(loaded.tzRegion);
+  in.str(loaded.blockKeywords);
+  in.str(loaded.boostKeywords);
+  if (in.failed()) return false;
+  
+  settings = loaded;
+  LOG_INFO(SYS, "Settings loaded successfully\n");
+  return true;
+}
+
+bool loadSettings() {
+  if (!loadConfigFile(CONFIG_SETTINGS, decodeSettingsConfig, importSettingsConfig)) {
+    LOG_WARN(SYS, "Settings file not found - using defaults\n");
     return false;
   }
+  return true;
+}
+
+void encodeSettingsConfig(ConfigWriter& out) {
+  // The config worker may replace the strings while this writes
+  lockSettings();
+  Settings snapshot = settings;
+  unlockSettings();
   
-  DynamicJsonDocument doc(1024);
-  doc["fetchInterval"] = settings.fetchInterval;
-  doc["maxNewsAgeHours"] = settings.maxNewsAgeHours;
-  doc["tzRegion"] = settings.tzRegion;
-  doc["maxHeadlinesPerFeed"] = settings.maxHeadlinesPerFeed;
-  
-  size_t bytesWritten = serializeJson(doc, file);
-  file.close();
-  
-  Serial.printf("Settings saved (%d bytes)\n", bytesWritten);
-  return bytesWritten > 0;
+  out.u32(snapshot.fetchInterval);
+  out.u32(snapshot.maxNewsAgeHours);
+  out.u16(snapshot.maxHeadlinesPerFeed);
+  out.u8(snapshot.interleaveFeeds);
+  out.str(snapshot.tzRegion);
+  out.str(snapshot.blockKeywords);
+  out.str(snapshot.boostKeywords);
+}
+
+bool saveSettings() {
+  markConfigDirty(CONFIG_SETTINGS);
+  return true;
 }
 
 void loadConfiguration() {
-  Serial.println("Loading configuration...");
+  LOG_INFO(SYS, "Loading configuration...\n");
   
   if (!loadFeedsFromFile()) {
-    Serial.println("Using default feeds");
+    LOG_INFO(SYS, "Using default feeds\n");
     initializeDefaultFeeds();
   }
   
   if (!loadSettings()) {
-    Serial.println("Using default settings");
+    LOG_INFO(SYS, "Using default settings\n");
   }
   
-  Serial.printf("Configuration loaded: %d feeds, %d sec interval\n", 
+  compileKeywordFilter();
+  
+  LOG_INFO(SYS, "Configuration loaded: %d feeds, %d sec interval\n", 
                 feeds.size(), settings.fetchInterval);
 }
 
 void initializeDefaultFeeds() {
   feeds.clear();
   feeds = DEFAULT_FEEDS;
-  Serial.printf("Initialized %d default feeds\n", feeds.size());
+  normalizeFeedIds();
+  LOG_INFO(SYS, "Initialized %d default feeds\n", feeds.size());
 }
 
 String sanitizeString(const String& input) {
@@ -166,5 +272,5 @@ String sanitizeString(const String& input) {
 }
 
 void logMemoryUsage(const String& context) {
-  Serial.printf("[%s] Free heap: %d bytes\n", context.c_str(), ESP.getFreeHeap());
+  LOG_INFO(SYS, "[%s] Free heap: %d bytes\n", context.c_str(), ESP.getFreeHeap());
 }
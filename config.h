@@ -7,7 +7,7 @@
 #include <SPIFFS.h>
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
-#include <TinyXML2.h>
+#include "tinyxml2.h"
 #include <time.h>
 #include <AsyncTCP.h>
 #include <ESPmDNS.h>
@@ -22,21 +22,24 @@
 #define AP_PASS "12345678"
 #define HTTP_TIMEOUT 8000
 #define MAX_HEADLINES_PER_FEED 10
+#define MAX_RSS_HEADLINES 64
 #define JSON_BUFFER_SIZE 8192
 
-// File paths
-extern const char* CONFIG_PATH;
-extern const char* SETTINGS_PATH;
+// Longest feed name and URL accepted from the web UI; sized so one feed
+// always fits FEED_JSON_MAX, escapes included
+#define MAX_FEED_NAME 48
+#define MAX_FEED_URL 384
 
 // Data structures
 struct RSSFeed {
+  uint16_t id;  // stable across edits and reboots; 0 until assigned
   String name;
   String url;
   bool enabled;
   
-  RSSFeed() : enabled(true) {}
+  RSSFeed() : id(0), enabled(true) {}
   RSSFeed(const String& n, const String& u, bool e = true) 
-    : name(n), url(u), enabled(e) {}
+    : id(0), name(n), url(u), enabled(e) {}
 };
 
 struct Settings {
@@ -44,6 +47,9 @@ struct Settings {
   unsigned long maxNewsAgeHours = 24;  // 24 hours default
   String tzRegion = "Asia/Kolkata";
   int maxHeadlinesPerFeed = MAX_HEADLINES_PER_FEED;
+  bool interleaveFeeds = false;  // round-robin feeds instead of pure recency
+  String blockKeywords = "";     // comma separated, see rss_filter.h
+  String boostKeywords = "";
   
   Settings() = default;
 };
@@ -54,6 +60,7 @@ extern Preferences preferences;
 extern RTC_DS3231 rtc;
 extern Settings settings;
 extern std::vector<RSSFeed> feeds;
+extern volatile uint32_t feedListVersion;  // bumped, under the feeds lock, when the whole list is replaced
 extern unsigned long lastFetchTime;
 extern bool hasInternet;
 
@@ -61,8 +68,29 @@ extern bool hasInternet;
 bool initializeSPIFFS();
 void loadConfiguration();
 void saveConfiguration();  // Added this missing declaration
+bool saveSettings();    // written by the config store shortly after
 void initializeDefaultFeeds();
-bool saveFeedsToFile();
+bool saveFeedsToFile();  // same
+
+// Binary payloads for the config store
+class ConfigWriter;
+void encodeFeedsConfig(ConfigWriter& out);
+void encodeSettingsConfig(ConfigWriter& out);
+
+// 'settings' is replaced by the config worker while the config store
+// encodes it; both take this lock, and other readers copy under it
+void lockSettings();
+void unlockSettings();
+
+// 'feeds' is edited by web handlers and read by the fetcher task
+void lockFeeds();
+bool tryLockFeeds();  // for the display loop, which must never wait
+void unlockFeeds();
+
+// Feed ids; callers hold the feeds lock
+uint16_t assignFeedId();
+int findFeedIndex(uint16_t id);  // -1 if no feed has it
+void normalizeFeedIds();         // gives missing or repeated ids a fresh one
 
 // Time function declarations
 String getCurrentTimeString();
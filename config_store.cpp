@@ -0,0 +1,426 @@
+#include "config_store.h"
+#include "config.h"
+#include "p10_settings.h"
+#include "mem_policy.h"
+#include "log.h"
+
+ConfigStoreStats configStoreStats = {};
+
+struct ConfigFileEntry {
+  const char* name;
+  const char* path;
+  const char* tmpPath;
+  const char* jsonPath;  // what the file replaced; removed once converted
+  ConfigEncodeFn encode;
+};
+
+static const ConfigFileEntry configFiles[CONFIG_FILE_COUNT] = {
+  {"feeds", "/feeds.bin", "/feeds.bin.tmp", "/feeds.json", encodeFeedsConfig},
+  {"settings", "/settings.bin", "/settings.bin.tmp", "/settings.json", encodeSettingsConfig},
+  {"display", "/display.bin", "/display.bin.tmp", "/display.json", encodeDisplayConfig}
+};
+
+#define CONFIG_TRAILER "\n#cfg "
+#define CONFIG_MAX_FILE 65536  // larger files are not ours
+
+// Pending writes, shared between savers and the store task
+static portMUX_TYPE dirtyMux = portMUX_INITIALIZER_UNLOCKED;
+static bool dirty[CONFIG_FILE_COUNT];
+static unsigned long firstMark[CONFIG_FILE_COUNT];
+static unsigned long retryAt[CONFIG_FILE_COUNT];  // after a failed write
+static bool retrying[CONFIG_FILE_COUNT];
+static unsigned long lastMark[CONFIG_FILE_COUNT];
+
+static SemaphoreHandle_t writeMutex = nullptr;  // one writer at a time
+static TaskHandle_t storeTask = nullptr;
+static bool jsonPending[CONFIG_FILE_COUNT];      // imported; delete after the first write
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* data, size_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *data++;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+    }
+  }
+  return ~crc;
+}
+
+// Passes everything through to the file, keeping a CRC and byte count
+class CrcPrint : public Print {
+public:
+  explicit CrcPrint(File& file) : file(file) {}
+  
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* data, size_t len) override {
+    size_t written = file.write(data, len);
+    crc = crc32Update(crc, data, written);
+    length += written;
+    if (written != len) failed = true;
+    return written;
+  }
+  
+  uint32_t crc = 0;
+  size_t length = 0;
+  bool failed = false;
+
+private:
+  File& file;
+};
+
+ConfigWriter::ConfigWriter(Print& out, uint8_t kind) : out(out) {
+  u16(CONFIG_BIN_MAGIC);
+  u8(CONFIG_BIN_VERSION);
+  u8(kind);
+}
+
+void ConfigWriter::u8(uint8_t v) {
+  written += out.write(v);
+}
+
+void ConfigWriter::u16(uint16_t v) {
+  u8(v & 0xFF);
+  u8(v >> 8);
+}
+
+void ConfigWriter::u32(uint32_t v) {
+  u16(v & 0xFFFF);
+  u16(v >> 16);
+}
+
+void ConfigWriter::str(const String& s) {
+  uint16_t n = min(s.length(), static_cast<unsigned int>(UINT16_MAX));
+  u16(n);
+  written += out.write(reinterpret_cast<const uint8_t*>(s.c_str()), n);
+}
+
+ConfigReader::ConfigReader(char* data, size_t len, uint8_t kind) : data(data), len(len) {
+  if (u16() != CONFIG_BIN_MAGIC || u8() != CONFIG_BIN_VERSION || u8() != kind) {
+    bad = true;
+  }
+}
+
+bool ConfigReader::take(size_t n) {
+  if (bad || len - pos < n) {
+    bad = true;
+    return false;
+  }
+  return true;
+}
+
+uint8_t ConfigReader::u8() {
+  if (!take(1)) return 0;
+  return static_cast<uint8_t>(data[pos++]);
+}
+
+uint16_t ConfigReader::u16() {
+  uint16_t lo = u8();
+  return lo | (static_cast<uint16_t>(u8()) << 8);
+}
+
+uint32_t ConfigReader::u32() {
+  uint32_t lo = u16();
+  return lo | (static_cast<uint32_t>(u16()) << 16);
+}
+
+void ConfigReader::str(String& s) {
+  uint16_t n = u16();
+  if (!take(n)) return;
+  // Terminate in place for the assignment, then put the byte back
+  char* start = data + pos;
+  char saved = start[n];
+  start[n] = '\0';
+  s = start;
+  start[n] = saved;
+  pos += n;
+}
+
+static bool writeConfigFile(ConfigFile id) {
+  const ConfigFileEntry& entry = configFiles[id];
+  ConfigFileStats& stats = configStoreStats.files[id];
+  
+  File file = SPIFFS.open(entry.tmpPath, "w");
+  if (!file) {
+    LOG_ERROR(SYS, "Config store: cannot open %s\n", entry.tmpPath);
+    stats.failures++;
+    return false;
+  }
+  
+  CrcPrint out(file);
+  ConfigWriter writer(out, id);
+  entry.encode(writer);
+  uint32_t generation = stats.generation + 1;
+  size_t trailer = file.printf(CONFIG_TRAILER "gen=%u crc=%08x len=%u\n", generation, out.crc, out.length);
+  file.close();
+  
+  if (out.failed || out.length == 0 || trailer == 0) {
+    LOG_ERROR(SYS, "Config store: writing %s failed (flash full?)\n", entry.tmpPath);
+    SPIFFS.remove(entry.tmpPath);
+    stats.failures++;
+    return false;
+  }
+  
+  // SPIFFS can't rename onto an existing file. Between these two steps
+  // only the .tmp copy exists, and loading recovers from it.
+  SPIFFS.remove(entry.path);
+  if (!SPIFFS.rename(entry.tmpPath, entry.path)) {
+    LOG_ERROR(SYS, "Config store: rename to %s failed\n", entry.path);
+    stats.failures++;
+    return false;
+  }
+  
+  if (jsonPending[id]) {
+    jsonPending[id] = false;
+    SPIFFS.remove(entry.jsonPath);
+    SPIFFS.remove(String(entry.jsonPath) + ".tmp");
+  }
+  
+  stats.generation = generation;
+  stats.writes++;
+  stats.bytes += out.length + trailer;
+  LOG_INFO(SYS, "Config store: %s saved, gen %u, %u bytes (%u requests, %u writes)\n",
+                entry.name, generation, out.length, stats.requests, stats.writes);
+  return true;
+}
+
+// Writes the files that are due; returns ticks until the next one is, or
+// portMAX_DELAY if nothing is pending. 'failed' is set if a write failed.
+static TickType_t writeDueFiles(bool force, bool* failed = nullptr) {
+  TickType_t wait = portMAX_DELAY;
+  
+  for (uint8_t i = 0; i < CONFIG_FILE_COUNT; i++) {
+    unsigned long now = millis();
+    bool due = false;
+    uint32_t remaining = 0;
+    
+    portENTER_CRITICAL(&dirtyMux);
+    if (dirty[i]) {
+      uint32_t quiet = now - lastMark[i];
+      uint32_t waited = now - firstMark[i];
+      if (retrying[i] && !force && static_cast<int32_t>(retryAt[i] - now) > 0) {
+        remaining = retryAt[i] - now;
+      } else {
+        due = force || retrying[i] || quiet >= CONFIG_DEBOUNCE_MS || waited >= CONFIG_MAX_DELAY_MS;
+      }
+      if (due) {
+        // Cleared before writing: a change made during the write marks
+        // it dirty again and gets its own write
+        dirty[i] = false;
+        retrying[i] = false;
+      } else if (!retrying[i]) {
+        remaining = min(CONFIG_DEBOUNCE_MS - quiet, CONFIG_MAX_DELAY_MS - waited);
+      }
+    }
+    portEXIT_CRITICAL(&dirtyMux);
+    
+    if (due) {
+      xSemaphoreTake(writeMutex, portMAX_DELAY);
+      bool written = writeConfigFile(static_cast<ConfigFile>(i));
+      xSemaphoreGive(writeMutex);
+      if (!written) {
+        // Keep the change pending and try again later, without hammering
+        // a full or failing flash
+        portENTER_CRITICAL(&dirtyMux);
+        if (!dirty[i]) {
+          dirty[i] = true;
+          firstMark[i] = lastMark[i] = millis();
+        }
+        retrying[i] = true;
+        retryAt[i] = millis() + CONFIG_RETRY_MS;
+        portEXIT_CRITICAL(&dirtyMux);
+        remaining = CONFIG_RETRY_MS;
+        if (failed) *failed = true;
+      }
+    }
+    if (remaining > 0 && pdMS_TO_TICKS(remaining) < wait) {
+      wait = pdMS_TO_TICKS(remaining);
+    }
+  }
+  return wait;
+}
+
+static void configStoreTask(void* parameter) {
+  TickType_t wait = portMAX_DELAY;
+  for (;;) {
+    // Woken by every save request, which restarts its quiet window
+    ulTaskNotifyTake(pdTRUE, wait);
+    wait = writeDueFiles(false);
+  }
+}
+
+void startConfigStore() {
+  if (storeTask) return;
+  writeMutex = xSemaphoreCreateMutex();
+  xTaskCreate(configStoreTask, "Config_Store", 6144, NULL, 1, &storeTask);
+}
+
+void markConfigDirty(ConfigFile file) {
+  unsigned long now = millis();
+  portENTER_CRITICAL(&dirtyMux);
+  if (!dirty[file]) {
+    dirty[file] = true;
+    firstMark[file] = now;
+  }
+  lastMark[file] = now;
+  configStoreStats.files[file].requests++;
+  portEXIT_CRITICAL(&dirtyMux);
+  
+  if (storeTask) {
+    xTaskNotifyGive(storeTask);
+  }
+}
+
+bool flushConfigStore() {
+  if (!writeMutex) return true;
+  
+  for (int attempt = 0; attempt < CONFIG_FLUSH_ATTEMPTS; attempt++) {
+    bool failed = false;
+    writeDueFiles(true, &failed);
+    if (!failed) return true;
+    delay(100);
+  }
+  return false;
+}
+
+// A file read into memory and checked against its trailer
+struct LoadedCopy {
+  char* data = nullptr;
+  size_t length = 0;     // payload bytes, without the trailer
+  size_t size = 0;       // buffer held
+  uint32_t generation = 0;
+  bool valid = false;
+  
+  ~LoadedCopy() { memFree(data); }
+};
+
+// requireTrailer: false for JSON files, which may predate the store
+static void readCopy(const char* path, LoadedCopy& copy, bool requireTrailer) {
+  File file = SPIFFS.open(path, "r");
+  if (!file) return;
+  
+  size_t size = file.size();
+  if (size == 0 || size > CONFIG_MAX_FILE) {
+    file.close();
+    return;
+  }
+  copy.data = static_cast<char*>(memAlloc(size + 1, ALLOC_BULK));
+  if (!copy.data) {
+    file.close();
+    return;
+  }
+  copy.size = size + 1;
+  size_t got = file.read(reinterpret_cast<uint8_t*>(copy.data), size);
+  file.close();
+  copy.data[got] = '\0';
+  
+  // The trailer is the last line. Binary payloads can hold any byte, so
+  // it is found by scanning back from the end.
+  const size_t marker = strlen(CONFIG_TRAILER);
+  char* trailer = nullptr;
+  for (size_t i = got >= marker ? got - marker + 1 : 0; i-- > 0; ) {
+    if (memcmp(copy.data + i, CONFIG_TRAILER, marker) == 0) {
+      trailer = copy.data + i;
+      break;
+    }
+  }
+  if (!trailer) {
+    if (requireTrailer) {
+      LOG_WARN(SYS, "Config store: %s has no trailer, ignoring it\n", path);
+      configStoreStats.corrupt++;
+      return;
+    }
+    copy.length = got;
+    copy.valid = true;
+    return;
+  }
+  
+  unsigned int generation = 0, crc = 0, length = 0;
+  if (sscanf(trailer + marker, "gen=%u crc=%x len=%u", &generation, &crc, &length) != 3 ||
+      length != static_cast<size_t>(trailer - copy.data) ||
+      crc32Update(0, reinterpret_cast<uint8_t*>(copy.data), length) != crc) {
+    LOG_WARN(SYS, "Config store: %s is damaged, ignoring it\n", path);
+    configStoreStats.corrupt++;
+    return;
+  }
+  
+  *trailer = '\0';
+  copy.length = length;
+  copy.generation = generation;
+  copy.valid = true;
+}
+
+// Imports the JSON file a binary one replaced, and schedules the
+// binary write that retires it
+static bool importJsonFile(ConfigFile id, ConfigImportFn import) {
+  const ConfigFileEntry& entry = configFiles[id];
+  ConfigFileStats& stats = configStoreStats.files[id];
+  
+  LoadedCopy json;
+  LoadedCopy jsonTmp;
+  readCopy(entry.jsonPath, json, false);
+  readCopy((String(entry.jsonPath) + ".tmp").c_str(), jsonTmp, true);
+  LoadedCopy& chosen = jsonTmp.valid && (!json.valid || jsonTmp.generation > json.generation) ? jsonTmp : json;
+  if (!chosen.valid || !import(chosen.data, chosen.length)) return false;
+  
+  LOG_INFO(SYS, "Config store: imported %s, converting to %s\n", entry.jsonPath, entry.path);
+  stats.generation = chosen.generation;
+  stats.loadBytes = chosen.size;
+  stats.source = CONFIG_FROM_JSON;
+  jsonPending[id] = true;
+  markConfigDirty(id);
+  return true;
+}
+
+bool loadConfigFile(ConfigFile id, ConfigDecodeFn decode, ConfigImportFn import) {
+  const ConfigFileEntry& entry = configFiles[id];
+  ConfigFileStats& stats = configStoreStats.files[id];
+  unsigned long start = micros();
+  
+  LoadedCopy main;
+  LoadedCopy tmp;
+  readCopy(entry.path, main, true);
+  readCopy(entry.tmpPath, tmp, true);
+  
+  // A valid .tmp newer than the main copy means a write was cut off
+  // between writing it and the rename
+  bool useTmp = tmp.valid && (!main.valid || tmp.generation > main.generation);
+  LoadedCopy& chosen = useTmp ? tmp : main;
+  
+  bool loaded = false;
+  if (chosen.valid) {
+    ConfigReader reader(chosen.data, chosen.length, id);
+    loaded = decode(reader) && !reader.failed();
+    if (!loaded) {
+      LOG_WARN(SYS, "Config store: %s has an unknown layout, ignoring it\n", useTmp ? entry.tmpPath : entry.path);
+    }
+  }
+  
+  if (loaded) {
+    stats.generation = chosen.generation;
+    stats.loadBytes = chosen.size;
+    stats.source = CONFIG_FROM_BINARY;
+    if (useTmp) {
+      LOG_WARN(SYS, "Config store: recovered %s from %s\n", entry.path, entry.tmpPath);
+      configStoreStats.recovered++;
+      SPIFFS.remove(entry.path);
+      SPIFFS.rename(entry.tmpPath, entry.path);
+    } else if (tmp.data) {
+      // A stale or half-written copy from an interrupted save
+      SPIFFS.remove(entry.tmpPath);
+    }
+  } else {
+    loaded = importJsonFile(id, import);
+  }
+  
+  stats.loadUs = micros() - start;
+  return loaded;
+}
+
+const char* configFileName(ConfigFile file) {
+  return file < CONFIG_FILE_COUNT ? configFiles[file].name : "?";
+}
+
+const char* configSourceName(ConfigSource source) {
+  static const char* const names[] = {"defaults", "binary", "json"};
+  return source <= CONFIG_FROM_JSON ? names[source] : "?";
+}
@@ -0,0 +1,128 @@
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <Arduino.h>
+
+// Debounced, crash-safe persistence for the config files.
+//
+// Saving only marks a file dirty. A background task writes it once no
+// change has come in for CONFIG_DEBOUNCE_MS, or at the latest
+// CONFIG_MAX_DELAY_MS after the first one, so dragging a slider costs
+// one flash write instead of dozens.
+//
+// Each write goes to <path>.tmp and is then renamed over <path>. The
+// file ends in a trailer line:
+//   #cfg gen=<n> crc=<crc32 of the payload> len=<payload bytes>
+// On load the valid copy with the higher generation wins, so a power
+// cut at any point leaves either the old or the new contents.
+//
+// Payloads are packed binary (see ConfigWriter/ConfigReader below), so
+// boot reads each value straight into place with no JSON document.
+// When a .bin file is missing, the JSON file it replaced is imported
+// once and converted. The web API still speaks JSON.
+
+#define CONFIG_BIN_MAGIC 0x4350  // "PC"
+#define CONFIG_BIN_VERSION 1
+
+#define CONFIG_DEBOUNCE_MS 1500
+#define CONFIG_MAX_DELAY_MS 10000
+#define CONFIG_RETRY_MS 5000       // after a failed write; the file stays pending
+#define CONFIG_FLUSH_ATTEMPTS 3
+
+enum ConfigFile : uint8_t {
+  CONFIG_FEEDS = 0,
+  CONFIG_SETTINGS,
+  CONFIG_DISPLAY,
+  CONFIG_FILE_COUNT
+};
+
+enum ConfigSource : uint8_t {
+  CONFIG_FROM_DEFAULTS = 0,
+  CONFIG_FROM_BINARY,
+  CONFIG_FROM_JSON      // imported from the pre-binary file
+};
+
+struct ConfigFileStats {
+  uint32_t requests;    // saves asked for
+  uint32_t writes;      // flash writes they were coalesced into
+  uint32_t bytes;
+  uint32_t failures;
+  uint32_t generation;  // of the copy on flash
+  uint32_t loadUs;      // read and parse at boot
+  uint32_t loadBytes;   // file buffer held while parsing
+  ConfigSource source;
+};
+
+struct ConfigStoreStats {
+  ConfigFileStats files[CONFIG_FILE_COUNT];
+  uint32_t recovered;   // loads that had to use the .tmp copy
+  uint32_t corrupt;     // copies rejected for a bad length or CRC
+};
+
+extern ConfigStoreStats configStoreStats;
+
+// Packs values for a binary payload, little-endian. Strings are a
+// 16-bit length and the bytes.
+class ConfigWriter {
+public:
+  ConfigWriter(Print& out, uint8_t kind);
+  
+  void u8(uint8_t v);
+  void u16(uint16_t v);
+  void u32(uint32_t v);
+  void str(const String& s);
+  
+  size_t length() const { return written; }
+
+private:
+  Print& out;
+  size_t written = 0;
+};
+
+// Unpacks a payload in place. Reading past the end sets failed() and
+// returns zeros; strings are the only allocation.
+class ConfigReader {
+public:
+  ConfigReader(char* data, size_t len, uint8_t kind);
+  
+  uint8_t u8();
+  uint16_t u16();
+  uint32_t u32();
+  void str(String& s);
+  
+  bool failed() const { return bad; }
+
+private:
+  bool take(size_t n);
+  
+  char* data;
+  size_t len;
+  size_t pos = 0;
+  bool bad = false;
+};
+
+// Writes a file's binary payload
+typedef void (*ConfigEncodeFn)(ConfigWriter& out);
+// Parses a binary payload; false rejects the copy
+typedef bool (*ConfigDecodeFn)(ConfigReader& in);
+// Imports the JSON file the binary one replaced; data is NUL terminated
+// and may be modified
+typedef bool (*ConfigImportFn)(char* data, size_t len);
+
+void startConfigStore();
+
+// Schedules a write of the file's current contents
+void markConfigDirty(ConfigFile file);
+
+// Writes everything pending right away, e.g. before a reboot. false if
+// a file still could not be written after a few attempts.
+bool flushConfigStore();
+
+// Loads the binary file, or imports its JSON predecessor and schedules
+// the conversion. false if neither is usable.
+bool loadConfigFile(ConfigFile file, ConfigDecodeFn decode, ConfigImportFn import);
+
+const char* configFileName(ConfigFile file);
+const char* configSourceName(ConfigSource source);
+
+#endif
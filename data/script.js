@@ -14,7 +14,7 @@ function updateSystemStatus() {
         .then(r => r.json())
         .then(data => {
             document.getElementById('freeMemory').textContent = data.freeMemory;
-            document.getElementById('wifiStatus').textContent = data.wifi;
+            showSystemStatus(data);
         })
         .catch(err => {
             document.getElementById('freeMemory').textContent = 'Error';
@@ -22,6 +22,34 @@ function updateSystemStatus() {
         });
 }
 
+function showSystemStatus(data) {
+    document.getElementById('wifiStatus').textContent = data.wifi;
+    const f = data.fetch;
+    document.getElementById('fetchStatus').textContent = f.inProgress
+        ? `In progress (${f.feedsDone}/${f.feedsTotal} feeds)`
+        : `Idle, last cycle ${f.succeeded} ok / ${f.failed} failed, ${f.headlines} headlines`;
+}
+
+// The device pushes time, status, what is on the panel and changed metrics
+function connectEvents() {
+    const source = new EventSource('/events');
+    source.addEventListener('time', e => {
+        document.getElementById('currentTime').textContent = e.data;
+    });
+    source.addEventListener('status', e => {
+        showSystemStatus(JSON.parse(e.data));
+    });
+    source.addEventListener('content', e => {
+        document.getElementById('nowShowing').textContent = e.data;
+    });
+    source.addEventListener('metrics', e => {
+        const m = JSON.parse(e.data);
+        if (m.freeMemory !== undefined) {
+            document.getElementById('freeMemory').textContent = m.freeMemory;
+        }
+    });
+}
+
 function loadDisplaySettings() {
     fetch('/display/settings')
         .then(r => r.json())
@@ -33,6 +61,9 @@ function loadDisplaySettings() {
             document.getElementById('fontType').value = data.fontType;
             document.getElementById('animationType').value = data.animationType;
             document.getElementById('animationEnabled').checked = data.animationEnabled;
+            document.getElementById('marqueeMode').checked = data.marqueeMode;
+            document.getElementById('layout').value = data.layout;
+            document.getElementById('previewFps').value = data.previewFps;
         })
         .catch(err => showStatus('Error loading display settings', 'error'));
 }
@@ -45,7 +76,9 @@ function updateDisplaySettings() {
         panelType: parseInt(document.getElementById('panelType').value),
         fontType: parseInt(document.getElementById('fontType').value),
         animationType: parseInt(document.getElementById('animationType').value),
-        animationEnabled: document.getElementById('animationEnabled').checked
+        animationEnabled: document.getElementById('animationEnabled').checked,
+        marqueeMode: document.getElementById('marqueeMode').checked,
+        layout: parseInt(document.getElementById('layout').value)
     };
     
     fetch('/display/settings', {
@@ -58,6 +91,83 @@ function updateDisplaySettings() {
     .catch(err => showStatus('Error updating display settings', 'error'));
 }
 
+// Live preview: binary frames of RLE-encoded changed rows (see
+// p10_preview_codec.h), applied onto the previous frame
+let previewSocket = null;
+let previewImage = null;
+
+function drawPreviewFrame(buffer) {
+    const bytes = new Uint8Array(buffer);
+    if (bytes.length < 6 || bytes[0] !== 0x50) return;
+    const keyframe = bytes[1] & 1;
+    const width = bytes[2];
+    const height = bytes[3];
+    
+    const canvas = document.getElementById('previewCanvas');
+    const ctx = canvas.getContext('2d');
+    if (!previewImage || previewImage.width !== width || previewImage.height !== height) {
+        // Diffs need a base frame; wait for the next keyframe
+        if (!keyframe) return;
+        canvas.width = width;
+        canvas.height = height;
+        previewImage = ctx.createImageData(width, height);
+    }
+    
+    const px = previewImage.data;
+    let p = 6;
+    while (p < bytes.length) {
+        const y = bytes[p++];
+        let x = 0;
+        while (x < width && p + 2 < bytes.length) {
+            const count = bytes[p];
+            const color = bytes[p + 1] | (bytes[p + 2] << 8);
+            p += 3;
+            const r = ((color >> 11) & 0x1F) * 255 / 31;
+            const g = ((color >> 5) & 0x3F) * 255 / 63;
+            const b = (color & 0x1F) * 255 / 31;
+            for (let i = 0; i < count; i++, x++) {
+                const o = (y * width + x) * 4;
+                px[o] = r;
+                px[o + 1] = g;
+                px[o + 2] = b;
+                px[o + 3] = 255;
+            }
+        }
+    }
+    ctx.putImageData(previewImage, 0, 0);
+}
+
+function closePreview() {
+    if (previewSocket) {
+        previewSocket.onclose = null;
+        previewSocket.close();
+        previewSocket = null;
+    }
+}
+
+function togglePreview() {
+    closePreview();
+    if (!document.getElementById('previewWatch').checked || document.hidden) return;
+    
+    previewImage = null;
+    previewSocket = new WebSocket(`ws://${location.host}/ws/preview`);
+    previewSocket.binaryType = 'arraybuffer';
+    previewSocket.onmessage = e => drawPreviewFrame(e.data);
+    previewSocket.onclose = () => {
+        previewSocket = null;
+        document.getElementById('previewWatch').checked = false;
+    };
+}
+
+function updatePreviewFps() {
+    fetch('/display/settings', {
+        method: 'POST',
+        headers: {'Content-Type': 'application/json'},
+        body: JSON.stringify({previewFps: parseInt(document.getElementById('previewFps').value)})
+    })
+    .catch(err => showStatus('Error updating preview frame rate', 'error'));
+}
+
 function updateScrollContent() {
     const contents = {
         time: document.getElementById('content_time').checked,
@@ -124,20 +234,20 @@ function loadFeeds() {
             const feedsList = document.getElementById('feedsList');
             feedsList.innerHTML = '';
             
-            feeds.forEach((feed, index) => {
+            feeds.forEach(feed => {
                 const feedDiv = document.createElement('div');
                 feedDiv.className = 'feed-item';
                 feedDiv.innerHTML = `
                     <div class="feed-controls">
                         <label>
                             <input type="checkbox" ${feed.enabled ? 'checked' : ''} 
-                                   onchange="toggleFeed(${index}, this.checked)">
+                                   onchange="toggleFeed(${feed.id}, this.checked)">
                             <strong>${feed.name}</strong>
                         </label>
-                        <button onclick="removeFeed(${index})" class="remove-btn">Remove</button>
+                        <button onclick="removeFeed(${feed.id})" class="remove-btn">Remove</button>
                     </div>
                     <input type="text" value="${feed.url}" 
-                           onchange="updateFeedUrl(${index}, this.value)" 
+                           onchange="updateFeedUrl(${feed.id}, this.value)" 
                            placeholder="RSS Feed URL">
                 `;
                 feedsList.appendChild(feedDiv);
@@ -146,36 +256,30 @@ function loadFeeds() {
         .catch(err => showStatus('Error loading feeds', 'error'));
 }
 
-function toggleFeed(index, enabled) {
-    fetch('/feeds')
-        .then(r => r.json())
-        .then(feeds => {
-            feeds[index].enabled = enabled;
-            return fetch('/feeds', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify(feeds)
-            });
-        })
-        .then(r => r.text())
-        .then(msg => showStatus(`Feed ${enabled ? 'enabled' : 'disabled'}`, 'success'))
-        .catch(err => showStatus('Error updating feed', 'error'));
+// Sends one feed edit; rejects with the server's message on an error status
+function sendFeedRequest(method, id, body) {
+    const query = id === null ? '' : `?id=${id}`;
+    const options = {method: method};
+    if (body) {
+        options.headers = {'Content-Type': 'application/json'};
+        options.body = JSON.stringify(body);
+    }
+    return fetch(`/feed${query}`, options).then(r => {
+        if (!r.ok) return r.text().then(msg => Promise.reject(new Error(msg)));
+        return r;
+    });
 }
 
-function updateFeedUrl(index, newUrl) {
-    fetch('/feeds')
-        .then(r => r.json())
-        .then(feeds => {
-            feeds[index].url = newUrl;
-            return fetch('/feeds', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify(feeds)
-            });
-        })
-        .then(r => r.text())
-        .then(msg => showStatus('Feed URL updated', 'success'))
-        .catch(err => showStatus('Error updating feed URL', 'error'));
+function toggleFeed(id, enabled) {
+    sendFeedRequest('PUT', id, {enabled: enabled})
+        .then(() => showStatus(`Feed ${enabled ? 'enabled' : 'disabled'}`, 'success'))
+        .catch(err => showStatus(`Error updating feed: ${err.message}`, 'error'));
+}
+
+function updateFeedUrl(id, newUrl) {
+    sendFeedRequest('PUT', id, {url: newUrl})
+        .then(() => showStatus('Feed URL updated', 'success'))
+        .catch(err => showStatus(`Error updating feed URL: ${err.message}`, 'error'));
 }
 
 function addNewFeed() {
@@ -185,43 +289,23 @@ function addNewFeed() {
     const url = prompt('Enter RSS feed URL:');
     if (!url) return;
     
-    fetch('/feeds')
-        .then(r => r.json())
-        .then(feeds => {
-            feeds.push({name: name, url: url, enabled: true});
-            return fetch('/feeds', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify(feeds)
-            });
-        })
-        .then(r => r.text())
-        .then(msg => {
+    sendFeedRequest('POST', null, {name: name, url: url, enabled: true})
+        .then(() => {
             showStatus('Feed added successfully', 'success');
             loadFeeds();
         })
-        .catch(err => showStatus('Error adding feed', 'error'));
+        .catch(err => showStatus(`Error adding feed: ${err.message}`, 'error'));
 }
 
-function removeFeed(index) {
+function removeFeed(id) {
     if (!confirm('Are you sure you want to remove this feed?')) return;
     
-    fetch('/feeds')
-        .then(r => r.json())
-        .then(feeds => {
-            feeds.splice(index, 1);
-            return fetch('/feeds', {
-                method: 'POST',
-                headers: {'Content-Type': 'application/json'},
-                body: JSON.stringify(feeds)
-            });
-        })
-        .then(r => r.text())
-        .then(msg => {
+    sendFeedRequest('DELETE', id)
+        .then(() => {
             showStatus('Feed removed', 'success');
             loadFeeds();
         })
-        .catch(err => showStatus('Error removing feed', 'error'));
+        .catch(err => showStatus(`Error removing feed: ${err.message}`, 'error'));
 }
 
 function resetFeeds() {
@@ -243,6 +327,9 @@ function loadRSSSettings() {
             document.getElementById('fetchInterval').value = data.fetchInterval;
             document.getElementById('maxNewsAgeHours').value = data.maxNewsAgeHours;
             document.getElementById('maxHeadlinesPerFeed').value = data.maxHeadlinesPerFeed;
+            document.getElementById('interleaveFeeds').checked = data.interleaveFeeds;
+            document.getElementById('blockKeywords').value = data.blockKeywords || '';
+            document.getElementById('boostKeywords').value = data.boostKeywords || '';
             document.getElementById('timezone').value = data.tzRegion;
         })
         .catch(err => showStatus('Error loading RSS settings', 'error'));
@@ -253,6 +340,9 @@ function updateRSSSettings() {
         fetchInterval: parseInt(document.getElementById('fetchInterval').value),
         maxNewsAgeHours: parseInt(document.getElementById('maxNewsAgeHours').value),
         maxHeadlinesPerFeed: parseInt(document.getElementById('maxHeadlinesPerFeed').value),
+        interleaveFeeds: document.getElementById('interleaveFeeds').checked,
+        blockKeywords: document.getElementById('blockKeywords').value,
+        boostKeywords: document.getElementById('boostKeywords').value,
         tzRegion: document.getElementById('timezone').value
     };
     
@@ -270,7 +360,10 @@ function fetchRSS() {
     showStatus('Fetching RSS feeds...', 'success');
     fetch('/feeds/fetch', {method: 'POST'})
         .then(r => r.text())
-        .then(msg => showStatus('RSS fetch completed: ' + msg, 'success'))
+        .then(msg => {
+            showStatus(msg, 'success');
+            updateSystemStatus();
+        })
         .catch(err => showStatus('Error fetching RSS', 'error'));
 }
 
@@ -288,9 +381,21 @@ document.addEventListener('DOMContentLoaded', function() {
     loadRSSSettings();
     loadFeeds();
     
-    // Update time every 30 seconds
-    setInterval(updateTime, 30000);
+    if (window.EventSource) {
+        connectEvents();
+    } else {
+        // No push support: fall back to polling
+        setInterval(updateTime, 30000);
+        setInterval(updateSystemStatus, 60000);
+    }
     
-    // Update system status every 60 seconds
-    setInterval(updateSystemStatus, 60000);
+    // The device only encodes frames while a socket is open, so a hidden
+    // tab lets go of it
+    document.addEventListener('visibilitychange', () => {
+        if (document.hidden) {
+            closePreview();
+        } else {
+            togglePreview();
+        }
+    });
 });
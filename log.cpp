@@ -0,0 +1,146 @@
+#include "log.h"
+#include "mem_policy.h"
+#include <atomic>
+#include <stdarg.h>
+
+static const uint8_t logCeilings[LOG_MOD_COUNT] = {
+  LOG_MAX_SYS, LOG_MAX_DISPLAY, LOG_MAX_RSS, LOG_MAX_WEB
+};
+static const char* const moduleNames[LOG_MOD_COUNT] = {"sys", "display", "rss", "web"};
+static const char levelLetters[] = "-EWIDT";
+
+volatile uint8_t logLevels[LOG_MOD_COUNT] = {
+  LOG_MAX_SYS, LOG_MAX_DISPLAY, LOG_MAX_RSS, LOG_MAX_WEB
+};
+
+// A slot holds ticket t once seq == t + 1; producers claim tickets with a
+// CAS and never wait, the drain task consumes them in ticket order
+struct LogSlot {
+  std::atomic<uint32_t> seq;
+  char text[LOG_LINE_MAX];
+};
+
+static LogSlot* slots = nullptr;
+static std::atomic<uint32_t> writeTicket(0);
+static std::atomic<uint32_t> readTicket(0);
+static std::atomic<uint32_t> dropped(0);
+
+// Drained text for /log; only the drain task writes it
+static char* history = nullptr;
+static size_t historyHead = 0;  // next write position
+static size_t historyLen = 0;
+static SemaphoreHandle_t historyMutex = nullptr;
+
+static void appendHistory(const char* text, size_t len) {
+  xSemaphoreTake(historyMutex, portMAX_DELAY);
+  for (size_t i = 0; i < len; i++) {
+    history[historyHead] = text[i];
+    historyHead = (historyHead + 1) % LOG_HISTORY;
+  }
+  historyLen = min(historyLen + len, static_cast<size_t>(LOG_HISTORY));
+  xSemaphoreGive(historyMutex);
+}
+
+static void logDrainTask(void* parameter) {
+  for (;;) {
+    uint32_t ticket = readTicket.load(std::memory_order_relaxed);
+    LogSlot& slot = slots[ticket % LOG_SLOTS];
+    
+    if (slot.seq.load(std::memory_order_acquire) != ticket + 1) {
+      vTaskDelay(pdMS_TO_TICKS(20));
+      continue;
+    }
+    
+    size_t len = strlen(slot.text);
+    Serial.write(reinterpret_cast<const uint8_t*>(slot.text), len);
+    appendHistory(slot.text, len);
+    readTicket.store(ticket + 1, std::memory_order_release);
+  }
+}
+
+void logBegin() {
+  if (slots) return;
+  
+  // Log text is cold; keep it out of internal RAM where there is PSRAM
+  slots = static_cast<LogSlot*>(memAlloc(sizeof(LogSlot) * LOG_SLOTS, ALLOC_BULK));
+  history = static_cast<char*>(memAlloc(LOG_HISTORY, ALLOC_BULK));
+  if (!slots || !history) {
+    memFree(slots);
+    memFree(history);
+    slots = nullptr;
+    history = nullptr;
+    Serial.println("Log buffer allocation failed - logging directly to Serial");
+    return;
+  }
+  for (size_t i = 0; i < LOG_SLOTS; i++) {
+    new (&slots[i].seq) std::atomic<uint32_t>(0);
+  }
+  
+  historyMutex = xSemaphoreCreateMutex();
+  xTaskCreate(logDrainTask, "Log_Drain", 3072, NULL, tskIDLE_PRIORITY, NULL);
+}
+
+void logWrite(LogModule module, uint8_t level, const char* fmt, ...) {
+  char line[LOG_LINE_MAX];
+  int prefix = snprintf(line, sizeof(line), "[%lu] %c %s: ", millis(), levelLetters[level], moduleNames[module]);
+  
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(line + prefix, sizeof(line) - prefix, fmt, args);
+  va_end(args);
+  
+  // Messages carry their own newlines, like Serial.printf; make sure the
+  // line ends with one even when it was truncated
+  size_t len = strlen(line);
+  if (line[len - 1] != '\n') {
+    len = min(len, sizeof(line) - 2);
+    line[len++] = '\n';
+    line[len] = '\0';
+  }
+  
+  if (!slots) {
+    Serial.write(reinterpret_cast<const uint8_t*>(line), len);
+    return;
+  }
+  
+  // Claim a ticket only if its slot has been drained; otherwise drop
+  uint32_t ticket = writeTicket.load(std::memory_order_relaxed);
+  do {
+    if (ticket - readTicket.load(std::memory_order_acquire) >= LOG_SLOTS) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  } while (!writeTicket.compare_exchange_weak(ticket, ticket + 1, std::memory_order_relaxed));
+  
+  LogSlot& slot = slots[ticket % LOG_SLOTS];
+  memcpy(slot.text, line, len + 1);
+  slot.seq.store(ticket + 1, std::memory_order_release);
+}
+
+bool setLogLevel(const String& module, uint8_t level) {
+  for (int i = 0; i < LOG_MOD_COUNT; i++) {
+    if (module == moduleNames[i]) {
+      logLevels[i] = min(level, logCeilings[i]);
+      return true;
+    }
+  }
+  return false;
+}
+
+String logHistory() {
+  String text;
+  if (!history) return text;
+  
+  xSemaphoreTake(historyMutex, portMAX_DELAY);
+  text.reserve(historyLen);
+  size_t start = (historyHead + LOG_HISTORY - historyLen) % LOG_HISTORY;
+  for (size_t i = 0; i < historyLen; i++) {
+    text += history[(start + i) % LOG_HISTORY];
+  }
+  xSemaphoreGive(historyMutex);
+  return text;
+}
+
+uint32_t logDropped() {
+  return dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,86 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+
+// Structured logging.
+//
+//   LOG_DEBUG(DISPLAY, "Width: %d", width);
+//
+// Each module has a build-time ceiling (LOG_MAX_<module>, default
+// LOG_COMPILE_LEVEL); calls above it are constant-false and compile to
+// nothing, arguments included. Below it, a runtime level per module can
+// be lowered or raised up to the ceiling from /log/level.
+//
+// Enabled lines are formatted into a lock-free ring of slots and written
+// to Serial by a low-priority task, so a log call never waits on the
+// UART. If the ring is full the line is dropped and counted. The last
+// few KB are kept for the /log endpoint.
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_TRACE 5
+
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_MAX_SYS
+#define LOG_MAX_SYS LOG_COMPILE_LEVEL
+#endif
+#ifndef LOG_MAX_DISPLAY
+#define LOG_MAX_DISPLAY LOG_COMPILE_LEVEL
+#endif
+#ifndef LOG_MAX_RSS
+#define LOG_MAX_RSS LOG_COMPILE_LEVEL
+#endif
+#ifndef LOG_MAX_WEB
+#define LOG_MAX_WEB LOG_COMPILE_LEVEL
+#endif
+
+#define LOG_SLOTS 32         // lines waiting for the drain task
+#define LOG_LINE_MAX 128     // longer lines are truncated
+#define LOG_HISTORY 4096     // bytes kept for /log
+
+enum LogModule : uint8_t {
+  LOG_MOD_SYS = 0,
+  LOG_MOD_DISPLAY,
+  LOG_MOD_RSS,
+  LOG_MOD_WEB,
+  LOG_MOD_COUNT
+};
+
+// Runtime level per module
+extern volatile uint8_t logLevels[LOG_MOD_COUNT];
+
+#define LOG_AT(mod, level, fmt, ...)                                        \
+  do {                                                                      \
+    if ((level) <= LOG_MAX_##mod && (level) <= logLevels[LOG_MOD_##mod]) {  \
+      logWrite(LOG_MOD_##mod, (level), fmt, ##__VA_ARGS__);                 \
+    }                                                                       \
+  } while (0)
+
+#define LOG_ERROR(mod, fmt, ...) LOG_AT(mod, LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#define LOG_WARN(mod, fmt, ...) LOG_AT(mod, LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#define LOG_INFO(mod, fmt, ...) LOG_AT(mod, LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#define LOG_DEBUG(mod, fmt, ...) LOG_AT(mod, LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#define LOG_TRACE(mod, fmt, ...) LOG_AT(mod, LOG_LEVEL_TRACE, fmt, ##__VA_ARGS__)
+
+// Starts the drain task; lines logged before this go straight to Serial
+void logBegin();
+
+void logWrite(LogModule module, uint8_t level, const char* fmt, ...)
+  __attribute__((format(printf, 3, 4)));
+
+// Sets a module's runtime level, capped at its build-time ceiling.
+// False for an unknown module name.
+bool setLogLevel(const String& module, uint8_t level);
+
+// Recent log text, oldest first
+String logHistory();
+uint32_t logDropped();
+
+#endif
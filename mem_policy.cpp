@@ -0,0 +1,85 @@
+#include "mem_policy.h"
+#include <esp_heap_caps.h>
+#include <soc/soc_memory_layout.h>
+
+MemPolicyStats memPolicyStats = {};
+
+static portMUX_TYPE memPolicyMux = portMUX_INITIALIZER_UNLOCKED;
+
+static const char* const regionNames[REGION_COUNT] = {"internal", "psram"};
+
+static const uint32_t INTERNAL_CAPS = MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT;
+static const uint32_t DMA_CAPS = MALLOC_CAP_DMA | MALLOC_CAP_8BIT;
+static const uint32_t PSRAM_CAPS = MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT;
+
+static MemRegion regionOf(void* ptr) {
+  return esp_ptr_external_ram(ptr) ? REGION_PSRAM : REGION_INTERNAL;
+}
+
+static void recordAlloc(MemRegion region, size_t size) {
+  RegionUsage& usage = memPolicyStats.regions[region];
+  portENTER_CRITICAL(&memPolicyMux);
+  usage.liveBytes += size;
+  usage.allocs++;
+  if (usage.liveBytes > usage.peakBytes) usage.peakBytes = usage.liveBytes;
+  portEXIT_CRITICAL(&memPolicyMux);
+}
+
+void* memAlloc(size_t size, AllocClass cls) {
+  void* mem = nullptr;
+  
+  if (cls == ALLOC_BULK && psramFound()) {
+    mem = heap_caps_malloc(size, PSRAM_CAPS);
+    if (!mem) {
+      portENTER_CRITICAL(&memPolicyMux);
+      memPolicyStats.bulkFallbacks++;
+      memPolicyStats.regions[REGION_PSRAM].failures++;
+      portEXIT_CRITICAL(&memPolicyMux);
+    }
+  }
+  if (!mem) {
+    mem = heap_caps_malloc(size, cls == ALLOC_DMA ? DMA_CAPS : INTERNAL_CAPS);
+  }
+  
+  if (!mem) {
+    portENTER_CRITICAL(&memPolicyMux);
+    memPolicyStats.regions[REGION_INTERNAL].failures++;
+    portEXIT_CRITICAL(&memPolicyMux);
+    Serial.printf("memAlloc: %u bytes failed\n", size);
+    return nullptr;
+  }
+  
+  // Count what the heap actually handed out, so memFree() can subtract it
+  recordAlloc(regionOf(mem), heap_caps_get_allocated_size(mem));
+  return mem;
+}
+
+void memFree(void* ptr) {
+  if (!ptr) return;
+  
+  RegionUsage& usage = memPolicyStats.regions[regionOf(ptr)];
+  size_t size = heap_caps_get_allocated_size(ptr);
+  portENTER_CRITICAL(&memPolicyMux);
+  usage.liveBytes = usage.liveBytes > size ? usage.liveBytes - size : 0;
+  portEXIT_CRITICAL(&memPolicyMux);
+  heap_caps_free(ptr);
+}
+
+void* bulkAlloc(size_t size) {
+  return memAlloc(size, ALLOC_BULK);
+}
+
+const char* memRegionName(MemRegion region) {
+  return region < REGION_COUNT ? regionNames[region] : "?";
+}
+
+void BulkText::assign(const char* text, size_t n) {
+  data = static_cast<char*>(memAlloc(n + 1, ALLOC_BULK));
+  if (!data) {
+    len = 0;
+    return;
+  }
+  memcpy(data, text, n);
+  data[n] = '\0';
+  len = n;
+}
@@ -0,0 +1,107 @@
+#ifndef MEM_POLICY_H
+#define MEM_POLICY_H
+
+#include <Arduino.h>
+#include <new>
+
+// Allocation policy: where each kind of buffer should live.
+//
+// Internal SRAM is shared by the HUB75 DMA framebuffer, AsyncTCP, TLS and
+// every task stack, so it is kept for memory that needs it. Large buffers
+// that are only read now and then (feed payloads, XML nodes, the headline
+// store, the quotes cache) go to PSRAM when the board has it, and fall
+// back to internal RAM when it doesn't or PSRAM is full.
+
+enum AllocClass : uint8_t {
+  ALLOC_BULK = 0,  // large, cold, CPU only: PSRAM first
+  ALLOC_HOT,       // read per frame or from time-critical code: internal
+  ALLOC_DMA,       // touched by a DMA engine: internal, DMA capable
+  ALLOC_CLASS_COUNT
+};
+
+enum MemRegion : uint8_t {
+  REGION_INTERNAL = 0,
+  REGION_PSRAM,
+  REGION_COUNT
+};
+
+// What the policy has placed in one region
+struct RegionUsage {
+  uint32_t liveBytes;
+  uint32_t peakBytes;
+  uint32_t allocs;
+  uint32_t failures;
+};
+
+struct MemPolicyStats {
+  RegionUsage regions[REGION_COUNT];
+  uint32_t bulkFallbacks;  // bulk requests PSRAM could not take
+};
+
+extern MemPolicyStats memPolicyStats;
+
+// nullptr only if no allowed region has room
+void* memAlloc(size_t size, AllocClass cls);
+void memFree(void* ptr);
+
+// For APIs that take a plain malloc-style function. Returns nullptr like
+// memAlloc(), so the API must handle a failed allocation.
+void* bulkAlloc(size_t size);
+
+const char* memRegionName(MemRegion region);
+
+// std allocator that places container storage in bulk memory
+template <typename T>
+struct BulkAllocator {
+  typedef T value_type;
+  
+  BulkAllocator() = default;
+  template <typename U> BulkAllocator(const BulkAllocator<U>&) {}
+  
+  T* allocate(size_t n) {
+    void* mem = memAlloc(n * sizeof(T), ALLOC_BULK);
+    if (!mem) throw std::bad_alloc();
+    return static_cast<T*>(mem);
+  }
+  void deallocate(T* p, size_t) { memFree(p); }
+};
+
+template <typename T, typename U>
+bool operator==(const BulkAllocator<T>&, const BulkAllocator<U>&) { return true; }
+template <typename T, typename U>
+bool operator!=(const BulkAllocator<T>&, const BulkAllocator<U>&) { return false; }
+
+// Owned, immutable text in bulk memory; a String would keep it internal
+class BulkText {
+public:
+  BulkText() = default;
+  explicit BulkText(const String& text) { assign(text.c_str(), text.length()); }
+  BulkText(BulkText&& other) : data(other.data), len(other.len) {
+    other.data = nullptr;
+    other.len = 0;
+  }
+  BulkText& operator=(BulkText&& other) {
+    if (this != &other) {
+      memFree(data);
+      data = other.data;
+      len = other.len;
+      other.data = nullptr;
+      other.len = 0;
+    }
+    return *this;
+  }
+  BulkText(const BulkText&) = delete;
+  BulkText& operator=(const BulkText&) = delete;
+  ~BulkText() { memFree(data); }
+  
+  const char* c_str() const { return data ? data : ""; }
+  size_t length() const { return len; }
+  
+private:
+  void assign(const char* text, size_t n);
+  
+  char* data = nullptr;
+  size_t len = 0;
+};
+
+#endif
@@ -0,0 +1,115 @@
+#include "p10_compositor.h"
+#include "p10_content.h"
+#include "p10_marquee.h"
+#include "log.h"
+
+static DisplayZone zones[MAX_ZONES];
+static uint8_t zoneCount = 0;
+static uint8_t tickerIndex = 0;
+static int activeLayout = -1;
+
+static DisplayZone makeZone(ZoneSource source, int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t refreshMs) {
+  DisplayZone zone = {};
+  zone.source = source;
+  zone.x = x;
+  zone.y = y;
+  zone.w = w;
+  zone.h = h;
+  zone.font = FONT_MEDIUM;
+  zone.refreshMs = refreshMs;
+  zone.dirty = true;
+  return zone;
+}
+
+void applyLayout(LayoutMode mode) {
+  activeLayout = mode;
+  zoneCount = 0;
+  
+  switch (mode) {
+    case LAYOUT_CLOCK_TICKER:
+      zones[zoneCount++] = makeZone(ZONE_CLOCK, 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT / 2, 1000);
+      tickerIndex = zoneCount;
+      zones[zoneCount++] = makeZone(ZONE_TICKER, 0, DISPLAY_HEIGHT / 2, DISPLAY_WIDTH, DISPLAY_HEIGHT / 2, 0);
+      break;
+    default:
+      tickerIndex = zoneCount;
+      zones[zoneCount++] = makeZone(ZONE_TICKER, 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT, 0);
+      break;
+  }
+  
+  if (dma_display) {
+    dma_display->clearScreen();
+  }
+  LOG_INFO(DISPLAY, "Display layout %d: %d zone(s)\n", mode, zoneCount);
+}
+
+const DisplayZone& tickerZone() {
+  return zones[tickerIndex];
+}
+
+void clearZone(const DisplayZone& zone) {
+  if (!dma_display) return;
+  
+  if (zone.w == DISPLAY_WIDTH && zone.h == DISPLAY_HEIGHT) {
+    dma_display->clearScreen();
+  } else {
+    dma_display->fillRect(zone.x, zone.y, zone.w, zone.h, displaySettings.backgroundColor);
+  }
+}
+
+// Redraws only the character cells whose text changed since last time
+static void drawClockZone(DisplayZone& zone) {
+  String now = getCurrentTimeString();
+  uint8_t size = zone.font == FONT_LARGE ? 2 : 1;
+  int16_t advance = 6 * size;
+  int16_t x = zone.x + (zone.w - static_cast<int16_t>(now.length()) * advance) / 2;
+  int16_t y = zone.y + (zone.h - 8 * size) / 2;
+  uint16_t color = displaySettings.panelType == PANEL_MONO ? 0xF800 : displaySettings.textColor;
+  uint16_t background = displaySettings.backgroundColor;
+  
+  // A colour change from the web UI repaints every cell
+  if (zone.dirty || color != zone.shownColor || background != zone.shownBackground) {
+    clearZone(zone);
+    zone.shown[0] = '\0';
+    zone.shownColor = color;
+    zone.shownBackground = background;
+    zone.dirty = false;
+  }
+  
+  size_t shownLen = strlen(zone.shown);
+  for (size_t i = 0; i < now.length() && i < sizeof(zone.shown) - 1; i++) {
+    if (i < shownLen && zone.shown[i] == now[i]) continue;
+    // An opaque background paints the whole cell, so no separate clear
+    dma_display->drawChar(x + i * advance, y, now[i], color, background, size);
+  }
+  strlcpy(zone.shown, now.c_str(), sizeof(zone.shown));
+}
+
+bool renderZones() {
+  // Layout changes from the web UI take effect here, on the display loop
+  if (displaySettings.layout != activeLayout) {
+    applyLayout(static_cast<LayoutMode>(displaySettings.layout));
+  }
+  
+  bool passComplete = false;
+  unsigned long now = millis();
+  
+  for (uint8_t i = 0; i < zoneCount; i++) {
+    DisplayZone& zone = zones[i];
+    
+    if (zone.source == ZONE_TICKER) {
+      // With scrolling off, scrollText() holds the text still
+      passComplete = scrollText();
+      continue;
+    }
+    
+    if (!zone.dirty && now - zone.lastDraw < zone.refreshMs) continue;
+    zone.lastDraw = now;
+    if (dma_display) {
+      drawClockZone(zone);
+    }
+  }
+  
+  return passComplete;
+}
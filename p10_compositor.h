@@ -0,0 +1,53 @@
+#ifndef P10_COMPOSITOR_H
+#define P10_COMPOSITOR_H
+
+#include <Arduino.h>
+#include "p10_display.h"
+
+// Zone compositor. The panel is split into rectangles, each with its own
+// content source and refresh rate, and a zone is only drawn when it is
+// due. Drawing stays inside the zone, so zones never repaint each other.
+//
+// The ticker zone runs the content rotation (scrollText() or the
+// marquee) at full frame rate with the display settings' font and
+// animation, and shows the text still when scrolling is off. Colours
+// come from the display settings on every draw. Clock zones repaint once per refresh and only redraw the
+// character cells that changed.
+
+#define MAX_ZONES 3
+
+enum LayoutMode {
+  LAYOUT_SINGLE = 0,       // ticker on the whole panel
+  LAYOUT_CLOCK_TICKER = 1  // clock in the top half, ticker below
+};
+
+enum ZoneSource {
+  ZONE_TICKER = 0,
+  ZONE_CLOCK = 1
+};
+
+struct DisplayZone {
+  ZoneSource source;
+  int16_t x, y, w, h;
+  FontType font;           // clock zones; the ticker follows displaySettings
+  uint16_t refreshMs;      // 0 = every frame
+  unsigned long lastDraw;
+  bool dirty;              // repaint everything on the next draw
+  char shown[12];          // clock text currently on the panel
+  uint16_t shownColor;     // colours it was drawn in
+  uint16_t shownBackground;
+};
+
+// Called by renderZones() when displaySettings.layout changes
+void applyLayout(LayoutMode mode);
+
+// Draws the zones that are due. True when the ticker finished a pass.
+bool renderZones();
+
+// Where the ticker draws
+const DisplayZone& tickerZone();
+
+// Clears a zone to the background colour
+void clearZone(const DisplayZone& zone);
+
+#endif
@@ -2,175 +2,413 @@
 #include "p10_content.h"
 #include "p10_display.h"
 #include "p10_renderer.h"
+#include "log.h"
+
+// Item on screen; one of the prerender slots
+static PreparedContent* currentItem = nullptr;
+static volatile uint32_t contentSeq = 0;  // bumped on every switch
+
+// Guards slot text against currentContentText() on other tasks. Only the
+// prerender task writes text and only web code reads it this way, so the
+// display loop never takes it.
+static SemaphoreHandle_t contentTextMutex = xSemaphoreCreateMutex();
+
+// Runs on the prerender task: pick the next item by weight and build it
+void prepareNextContent(PreparedContent& item) {
+  static WeightedRotation rotation;
+  
+  uint8_t weights[SCHEDULER_MAX_ITEMS];
+  size_t count = min(scrollContents.size(), static_cast<size_t>(SCHEDULER_MAX_ITEMS));
+  for (size_t i = 0; i < count; i++) {
+    weights[i] = scrollContents[i].enabled ? scrollContents[i].schedule.weight : 0;
+  }
+  
+  int contentIndex = rotation.pickNext(weights, count);
+  if (contentIndex < 0) {
+    item.contentIndex = -1;
+    return;
+  }
+  
+  // In marquee mode the display pulls headlines itself as they scroll in
+  bool marquee = scrollContents[contentIndex].type == CONTENT_RSS_FEEDS && displaySettings.marqueeMode &&
+                 displaySettings.scrollEnabled && displaySettings.scrollDirection == 0;
+  
+  String text;
+  if (!marquee) {
+    switch (scrollContents[contentIndex].type) {
+      case CONTENT_TIME:
+        text = generateTimeContent();
+        break;
+      case CONTENT_DATE:
+        text = generateDateContent();
+        break;
+      case CONTENT_RSS_FEEDS:
+        text = generateRSSContent();
+        break;
+      case CONTENT_QUOTE_OF_DAY:
+        text = loadQuoteOfDay();
+        break;
+      case CONTENT_FUN_FACTS:
+        text = loadFunFact();
+        break;
+      case CONTENT_CUSTOM_TEXT:
+        text = scrollContents[contentIndex].content;
+        break;
+    }
+  }
+  
+  xSemaphoreTake(contentTextMutex, portMAX_DELAY);
+  item.text = std::move(text);
+  xSemaphoreGive(contentTextMutex);
+  
+  item.schedule = scrollContents[contentIndex].schedule;
+  item.contentIndex = contentIndex;
+  item.marquee = marquee;
+  item.fontType = displaySettings.fontType;
+  item.width = marquee ? 0 : calculateTextWidth(item.text);
+}
+
+uint32_t currentContentSeq() {
+  return contentSeq;
+}
+
+String currentContentText() {
+  xSemaphoreTake(contentTextMutex, portMAX_DELAY);
+  String text;
+  PreparedContent* item = currentItem;
+  if (item) {
+    text = item->marquee ? String("Headline marquee") : item->text;
+  }
+  xSemaphoreGive(contentTextMutex);
+  return text;
+}
+
+// One full pass of the item at the current speed, 0 if it doesn't scroll
+static uint32_t scrollPassMs(const PreparedContent& item) {
+  if (item.marquee) {
+    return max(headlineOrder.size(), static_cast<size_t>(1)) * MARQUEE_EST_ITEM_PX * displaySettings.scrollSpeed;
+  }
+  const DisplayZone& zone = tickerZone();
+  if (!displaySettings.scrollEnabled || item.width <= zone.w) {
+    return 0;
+  }
+  bool vertical = displaySettings.scrollDirection > 1 && zone.h == DISPLAY_HEIGHT;
+  uint32_t steps = vertical ? zone.h + 10 : item.width + zone.w;
+  return steps * displaySettings.scrollSpeed;
+}
+
+// Wants the next item; it is swapped in as soon as it is ready
+static bool advancePending = true;
+
+static void startAdvance() {
+  if (!advancePending) {
+    advancePending = true;
+    hurryNextContent();
+  }
+}
 
 void updateDisplayContent() {
-  static unsigned long lastContentUpdate = 0;
-  static int contentIndex = 0;
+  static DwellTracker dwell;
+  unsigned long now = millis();
   
-  // Update content every 5 seconds
-  if (millis() - lastContentUpdate > 5000) {
-    
-    // Find next enabled content
-    int attempts = 0;
-    do {
-      contentIndex = (contentIndex + 1) % scrollContents.size();
-      attempts++;
-    } while (!scrollContents[contentIndex].enabled && attempts < scrollContents.size());
-    
-    if (scrollContents[contentIndex].enabled) {
-      String newContent = "";
-      
-      switch (scrollContents[contentIndex].type) {
-        case CONTENT_TIME:
-          newContent = generateTimeContent();
-          break;
-        case CONTENT_DATE:
-          newContent = generateDateContent();
-          break;
-        case CONTENT_RSS_FEEDS:
-          newContent = generateRSSContent();
-          break;
-        case CONTENT_QUOTE_OF_DAY:
-          newContent = loadQuoteOfDay();
-          break;
-        case CONTENT_FUN_FACTS:
-          newContent = loadFunFact();
-          break;
-        case CONTENT_CUSTOM_TEXT:
-          newContent = scrollContents[contentIndex].content;
-          break;
-      }
-      
-      if (newContent != displaySettings.currentContent) {
-        displaySettings.currentContent = newContent;
+  if (!advancePending && dwell.due(now)) {
+    startAdvance();
+  }
+  
+  // The next item was prepared in the background, so switching is a
+  // pointer swap. If it isn't ready yet, the current one keeps going.
+  if (advancePending) {
+    PreparedContent* next = takePreparedContent();
+    if (next && next->contentIndex < 0) {
+      requestNextContent(now + CONTENT_IDLE_RETRY_MS);
+    } else if (next) {
+      if (next->marquee) {
+        // Back-to-back marquee items just keep streaming
+        if (!currentItem || !currentItem->marquee) {
+          marqueeBegin();
+          LOG_DEBUG(DISPLAY, "Display content updated: headline marquee\n");
+        }
+      } else if (!currentItem || currentItem->marquee || next->text != currentItem->text) {
         displaySettings.scrollPosition = 0;
-        
-        Serial.printf("Display content updated: %s\n", newContent.c_str());
+        LOG_DEBUG(DISPLAY, "Display content updated: %s\n", next->text.c_str());
       }
+      currentItem = next;
+      contentSeq++;
+      advancePending = false;
+      dwell.begin(next->schedule, now, scrollPassMs(*next));
+      // The previous item is off screen now, so its slot can be refilled
+      requestNextContent(dwell.expectedEnd() - CONTENT_PREP_LEAD_MS);
     }
-    
-    lastContentUpdate = millis();
   }
   
-  // Handle scrolling
-  if (displaySettings.scrollEnabled) {
-    scrollText();
+  // Draw the zones; the ticker finishing a pass is what normally ends an item
+  if (renderZones() && !advancePending && dwell.onScrollComplete(millis())) {
+    startAdvance();
   }
+  
+  // The frame is complete, so watchers see no half-drawn rows
+  previewFrameDone();
 }
 
-void scrollText() {
+// Draws the next scroll step; true when the text has just scrolled fully
+// through and wrapped
+bool scrollText() {
   if (millis() - displaySettings.lastScrollTime < displaySettings.scrollSpeed) {
-    return;
+    return false;
   }
   
-  if (displaySettings.currentContent.length() == 0) {
-    return;
+  if (currentItem && currentItem->marquee) {
+    return marqueeStep();
   }
   
-  // Calculate text width properly
-  int textWidth = calculateTextWidth(displaySettings.currentContent);
-  bool needsScrolling = textWidth > DISPLAY_WIDTH;
+  if (!currentItem || currentItem->text.length() == 0) {
+    return false;
+  }
   
-  Serial.printf("Content: '%s', Width: %d, Display: %d, Needs scrolling: %s\n", 
-                displaySettings.currentContent.c_str(), textWidth, DISPLAY_WIDTH, needsScrolling ? "YES" : "NO");
+  // Measured when prepared; only a font change since then needs a remeasure
+  if (currentItem->fontType != displaySettings.fontType) {
+    currentItem->fontType = displaySettings.fontType;
+    currentItem->width = calculateTextWidth(currentItem->text);
+  }
+  const String& text = currentItem->text;
+  int textWidth = currentItem->width;
   
-  if (dma_display) {
-    dma_display->clearScreen();
+  // Everything is drawn inside the ticker zone. A zone shorter than the
+  // panel has no room for vertical scrolling, so it scrolls left instead.
+  const DisplayZone& zone = tickerZone();
+  uint8_t direction = displaySettings.scrollDirection;
+  if (direction > 1 && zone.h < DISPLAY_HEIGHT) {
+    direction = 0;
   }
+  // Scrolling turned off shows the start of text that doesn't fit
+  bool needsScrolling = displaySettings.scrollEnabled && textWidth > zone.w;
+  
+  LOG_TRACE(DISPLAY, "Content: '%s', Width: %d, Display: %d, Needs scrolling: %s\n", 
+                text.c_str(), textWidth, zone.w, needsScrolling ? "YES" : "NO");
   
+  bool wrapped = false;
   if (needsScrolling) {
     // Handle different scroll directions
-    switch (displaySettings.scrollDirection) {
+    switch (direction) {
       case 0: // Left
         displaySettings.scrollPosition++;
-        if (displaySettings.scrollPosition >= textWidth + DISPLAY_WIDTH) {
+        if (displaySettings.scrollPosition >= textWidth + zone.w) {
           displaySettings.scrollPosition = 0;
+          wrapped = true;
         }
         break;
       case 1: // Right
         displaySettings.scrollPosition--;
-        if (displaySettings.scrollPosition <= -textWidth - DISPLAY_WIDTH) {
-          displaySettings.scrollPosition = DISPLAY_WIDTH;
+        if (displaySettings.scrollPosition <= -textWidth - zone.w) {
+          displaySettings.scrollPosition = zone.w;
+          wrapped = true;
         }
         break;
       case 2: // Up
         displaySettings.scrollPosition++;
-        if (displaySettings.scrollPosition >= DISPLAY_HEIGHT + 10) {
+        if (displaySettings.scrollPosition >= zone.h + 10) {
           displaySettings.scrollPosition = -10;
+          wrapped = true;
         }
         break;
       case 3: // Down
         displaySettings.scrollPosition--;
-        if (displaySettings.scrollPosition <= -DISPLAY_HEIGHT - 10) {
-          displaySettings.scrollPosition = DISPLAY_HEIGHT;
+        if (displaySettings.scrollPosition <= -zone.h - 10) {
+          displaySettings.scrollPosition = zone.h;
+          wrapped = true;
         }
         break;
     }
     
     int drawX, drawY;
     
-    if (displaySettings.scrollDirection <= 1) {
+    if (direction <= 1) {
       // Horizontal scrolling
-      drawX = (displaySettings.scrollDirection == 0) ? 
-              (DISPLAY_WIDTH - displaySettings.scrollPosition) : displaySettings.scrollPosition;
-      drawY = (DISPLAY_HEIGHT - 8) / 2; // Vertically centered
+      drawX = zone.x + ((direction == 0) ? 
+              (zone.w - displaySettings.scrollPosition) : displaySettings.scrollPosition);
+      drawY = zone.y + (zone.h - 8) / 2; // Vertically centered
     } else {
       // Vertical scrolling
-      drawX = (DISPLAY_WIDTH - textWidth) / 2;
+      drawX = (zone.w - textWidth) / 2;
       if (drawX < 0) drawX = 0;
-      drawY = (displaySettings.scrollDirection == 2) ? 
-              (DISPLAY_HEIGHT - displaySettings.scrollPosition) : displaySettings.scrollPosition;
+      drawX += zone.x;
+      drawY = zone.y + ((direction == 2) ? 
+              (zone.h - displaySettings.scrollPosition) : displaySettings.scrollPosition);
     }
     
-    drawTextWithAnimation(displaySettings.currentContent, drawX, drawY);
+    clearZone(zone);
+    drawTextWithAnimation(text, drawX, drawY);
     displaySettings.lastScrollTime = millis();
     
   } else {
     // Static text that fits
     static unsigned long lastStaticUpdate = 0;
     if (millis() - lastStaticUpdate > 1000) { // Update every second for time
-      int startX = (DISPLAY_WIDTH - textWidth) / 2;
+      int startX = (zone.w - textWidth) / 2;
       if (startX < 0) startX = 0;
-      int startY = (DISPLAY_HEIGHT - 8) / 2; // Vertically centered
+      startX += zone.x;
+      int startY = zone.y + (zone.h - 8) / 2; // Vertically centered
       
-      drawTextWithAnimation(displaySettings.currentContent, startX, startY);
+      clearZone(zone);
+      drawTextWithAnimation(text, startX, startY);
       lastStaticUpdate = millis();
-      Serial.printf("Static display: '%s' centered at (%d,%d)\n", displaySettings.currentContent.c_str(), startX, startY);
+      LOG_TRACE(DISPLAY, "Static display: '%s' centered at (%d,%d)\n", text.c_str(), startX, startY);
     }
   }
+  return wrapped;
 }
 
 void setScrollSpeed(uint8_t speed) {
   displaySettings.scrollSpeed = constrain(speed, 30, 200);
-  Serial.printf("Scroll speed set to: %d ms\n", displaySettings.scrollSpeed);
+  LOG_INFO(DISPLAY, "Scroll speed set to: %d ms\n", displaySettings.scrollSpeed);
 }
 
 void setScrollDirection(uint8_t direction) {
   displaySettings.scrollDirection = constrain(direction, 0, 3);
   displaySettings.scrollPosition = 0;
-  Serial.printf("Scroll direction set to: %d\n", displaySettings.scrollDirection);
+  LOG_INFO(DISPLAY, "Scroll direction set to: %d\n", displaySettings.scrollDirection);
 }
 
 void addScrollContent(ContentType type, const String& content) {
   ScrollContent newContent(type, content, true);
   newContent.content = content;
   scrollContents.push_back(newContent);
-  Serial.printf("Added scroll content: %s\n", content.c_str());
+  LOG_INFO(DISPLAY, "Added scroll content: %s\n", content.c_str());
+}
+
+// Position in headlineOrder. Kept across rebuilds, which happen after
+// every fetch, so the rotation carries on instead of restarting at the
+// top; it wraps if the order got shorter.
+static size_t headlineCursor = 0;
+
+// The fetcher task writes the headline store while the display loop reads it
+static SemaphoreHandle_t headlinesMutex = xSemaphoreCreateMutex();
+
+// Rotation priority: boosted topics, then stories new this cycle, then recency
+static bool showsBefore(const RSSHeadline& a, const RSSHeadline& b) {
+  if (a.boosted != b.boosted) return a.boosted;
+  if (a.isNew != b.isNew) return a.isNew;
+  return a.pubTime > b.pubTime;
 }
 
-void addRSSHeadline(const String& headline) {
-  allRSSHeadlines.push_back(headline);
+void addRSSHeadline(const String& headline, time_t pubTime, uint16_t feedId,
+                    bool isNew, bool boosted) {
+  RSSHeadline entry(headline, pubTime, feedId, isNew, boosted);
+  xSemaphoreTake(headlinesMutex, portMAX_DELAY);
+  
+  // Keep the store grouped by feed and in rotation priority within each
+  // feed, so every feed is one sorted run for rebuildHeadlineOrder()
+  auto pos = allRSSHeadlines.begin();
+  while (pos != allRSSHeadlines.end() &&
+         (pos->feedId < feedId ||
+          (pos->feedId == feedId && !showsBefore(entry, *pos)))) {
+    ++pos;
+  }
+  allRSSHeadlines.insert(pos, std::move(entry));
   
-  if (allRSSHeadlines.size() > 20) {
-    allRSSHeadlines.erase(allRSSHeadlines.begin());
+  if (allRSSHeadlines.size() > MAX_RSS_HEADLINES) {
+    // Drop the headline that would show last across all feeds: plain
+    // stories before new or boosted ones, the oldest among them
+    auto last = allRSSHeadlines.begin();
+    for (auto it = allRSSHeadlines.begin(); it != allRSSHeadlines.end(); ++it) {
+      if (showsBefore(*last, *it)) last = it;
+    }
+    allRSSHeadlines.erase(last);
   }
+  size_t total = allRSSHeadlines.size();
+  xSemaphoreGive(headlinesMutex);
   
-  Serial.printf("Added RSS headline: %s (Total: %d)\n", headline.c_str(), allRSSHeadlines.size());
+  LOG_DEBUG(RSS, "Added RSS headline: %s (Total: %u)\n", headline.c_str(), total);
 }
 
 void clearRSSHeadlines() {
+  xSemaphoreTake(headlinesMutex, portMAX_DELAY);
   allRSSHeadlines.clear();
-  Serial.println("Cleared all RSS headlines");
+  headlineOrder.clear();
+  headlineCursor = 0;
+  xSemaphoreGive(headlinesMutex);
+  LOG_INFO(RSS, "Cleared all RSS headlines\n");
+}
+
+void clearFeedHeadlines(uint16_t feedId) {
+  xSemaphoreTake(headlinesMutex, portMAX_DELAY);
+  allRSSHeadlines.erase(
+    std::remove_if(allRSSHeadlines.begin(), allRSSHeadlines.end(),
+                   [feedId](const RSSHeadline& h) { return h.feedId == feedId; }),
+    allRSSHeadlines.end());
+  xSemaphoreGive(headlinesMutex);
+}
+
+void removeFeedHeadlines(uint16_t feedId) {
+  clearFeedHeadlines(feedId);
+  rebuildHeadlineOrder();
+}
+
+// Head of one feed's run during the merge
+struct HeadlineRun {
+  uint16_t next;
+  uint16_t end;
+};
+
+// Heap order: highest-priority head on top, ties broken by feed id
+static bool runIsOlder(const HeadlineRun& a, const HeadlineRun& b) {
+  const RSSHeadline& ha = allRSSHeadlines[a.next];
+  const RSSHeadline& hb = allRSSHeadlines[b.next];
+  if (showsBefore(hb, ha)) return true;
+  if (showsBefore(ha, hb)) return false;
+  return ha.feedId > hb.feedId;
+}
+
+void rebuildHeadlineOrder() {
+  // Fixed scratch; there can never be more runs than headlines
+  static HeadlineRun runs[MAX_RSS_HEADLINES + 1];
+  static HeadlineRun round[MAX_RSS_HEADLINES + 1];
+  size_t runCount = 0;
+  xSemaphoreTake(headlinesMutex, portMAX_DELAY);
+  
+  for (size_t i = 0; i < allRSSHeadlines.size(); ) {
+    size_t j = i + 1;
+    while (j < allRSSHeadlines.size() && allRSSHeadlines[j].feedId == allRSSHeadlines[i].feedId) {
+      j++;
+    }
+    runs[runCount++] = {static_cast<uint16_t>(i), static_cast<uint16_t>(j)};
+    i = j;
+  }
+  
+  headlineOrder.clear();
+  std::make_heap(runs, runs + runCount, runIsOlder);
+  
+  if (!settings.interleaveFeeds) {
+    // k-way merge: always take the newest head of any feed
+    while (runCount > 0) {
+      std::pop_heap(runs, runs + runCount, runIsOlder);
+      HeadlineRun& run = runs[runCount - 1];
+      headlineOrder.push_back(run.next++);
+      if (run.next < run.end) {
+        std::push_heap(runs, runs + runCount, runIsOlder);
+      } else {
+        runCount--;
+      }
+    }
+  } else {
+    // Round-robin: one headline per feed per round, newest feed first
+    while (runCount > 0) {
+      size_t roundCount = 0;
+      while (runCount > 0) {
+        std::pop_heap(runs, runs + runCount, runIsOlder);
+        round[roundCount++] = runs[--runCount];
+      }
+      for (size_t r = 0; r < roundCount; r++) {
+        headlineOrder.push_back(round[r].next++);
+        if (round[r].next < round[r].end) {
+          runs[runCount++] = round[r];
+          std::push_heap(runs, runs + runCount, runIsOlder);
+        }
+      }
+    }
+  }
+  
+  xSemaphoreGive(headlinesMutex);
 }
 
 String generateTimeContent() {
@@ -182,61 +420,116 @@ String generateDateContent() {
 }
 
 String generateRSSContent() {
-  static int headlineIndex = 0;
+  // Runs on the prerender task, so waiting out a fetch never stalls the display
+  xSemaphoreTake(headlinesMutex, portMAX_DELAY);
   
-  if (allRSSHeadlines.size() > 0) {
-    String headline = allRSSHeadlines[headlineIndex];
-    headlineIndex = (headlineIndex + 1) % allRSSHeadlines.size();
-    return headline;
+  String text = "No RSS headlines available";
+  if (headlineOrder.size() > 0) {
+    if (headlineCursor >= headlineOrder.size()) {
+      headlineCursor = 0;
+    }
+    uint16_t index = headlineOrder[headlineCursor++];
+    if (index < allRSSHeadlines.size()) {
+      text = allRSSHeadlines[index].text.c_str();
+    }
   }
+  xSemaphoreGive(headlinesMutex);
   
-  return "No RSS headlines available";
+  return text;
 }
 
-String loadQuoteOfDay() {
-  File file = SPIFFS.open("/quotes.txt", "r");
-  if (!file) {
-    return "Believe you can and you're halfway there.";
+// Next headline in rotation order, for the marquee. Runs on the display
+// loop, so it never waits: false if a fetch holds the store. 'wrapped'
+// marks the first headline of a new pass through the rotation.
+bool nextMarqueeHeadline(String& text, uint16_t& feedId, bool& wrapped) {
+  if (xSemaphoreTake(headlinesMutex, 0) != pdTRUE) {
+    return false;
   }
   
-  std::vector<String> quotes;
-  while (file.available()) {
-    String line = file.readStringUntil('\n');
-    line.trim();
-    if (line.length() > 0) {
-      quotes.push_back(line);
+  text = "No RSS headlines available";
+  feedId = UINT16_MAX;
+  wrapped = true;
+  if (headlineOrder.size() > 0) {
+    if (headlineCursor >= headlineOrder.size()) {
+      headlineCursor = 0;
+    }
+    wrapped = headlineCursor == 0;
+    uint16_t index = headlineOrder[headlineCursor++];
+    if (index < allRSSHeadlines.size()) {
+      text = allRSSHeadlines[index].text.c_str();
+      feedId = allRSSHeadlines[index].feedId;
     }
   }
-  file.close();
-  
-  if (quotes.size() > 0) {
-    int randomIndex = random(0, quotes.size());
-    return quotes[randomIndex];
-  }
-  
-  return "No quotes available";
+  xSemaphoreGive(headlinesMutex);
+  return true;
 }
 
-String loadFunFact() {
-  File file = SPIFFS.open("/facts.txt", "r");
-  if (!file) {
-    return "The ESP32 has built-in Wi-Fi and Bluetooth!";
-  }
+// A quotes/facts file, read once into bulk memory as back-to-back
+// NUL-terminated lines instead of being re-read from SPIFFS every time
+struct LineCache {
+  const char* path;
+  char* data;
+  uint16_t count;
+  bool loaded;
+};
+
+static LineCache quoteCache = {"/quotes.txt", nullptr, 0, false};
+static LineCache factCache = {"/facts.txt", nullptr, 0, false};
+
+static void loadLineCache(LineCache& cache) {
+  cache.loaded = true;
+  File file = SPIFFS.open(cache.path, "r");
+  if (!file) return;
   
-  std::vector<String> facts;
-  while (file.available()) {
-    String line = file.readStringUntil('\n');
-    line.trim();
-    if (line.length() > 0) {
-      facts.push_back(line);
-    }
+  size_t size = file.size();
+  cache.data = static_cast<char*>(memAlloc(size + 1, ALLOC_BULK));
+  if (!cache.data) {
+    file.close();
+    return;
   }
+  size_t len = file.read(reinterpret_cast<uint8_t*>(cache.data), size);
   file.close();
   
-  if (facts.size() > 0) {
-    int randomIndex = random(0, facts.size());
-    return facts[randomIndex];
+  // Trim each line and pack the non-empty ones to the front
+  size_t out = 0;
+  size_t pos = 0;
+  while (pos < len) {
+    const char* nl = static_cast<const char*>(memchr(cache.data + pos, '\n', len - pos));
+    size_t lineEnd = nl ? nl - cache.data : len;
+    size_t start = pos;
+    size_t end = lineEnd;
+    while (start < end && isspace(static_cast<unsigned char>(cache.data[start]))) start++;
+    while (end > start && isspace(static_cast<unsigned char>(cache.data[end - 1]))) end--;
+    if (end > start) {
+      memmove(cache.data + out, cache.data + start, end - start);
+      out += end - start;
+      cache.data[out++] = '\0';
+      cache.count++;
+    }
+    pos = lineEnd + 1;
   }
+  LOG_INFO(DISPLAY, "Cached %u lines from %s\n", cache.count, cache.path);
+}
+
+static String randomCachedLine(LineCache& cache, const char* missing, const char* empty) {
+  if (!cache.loaded) {
+    loadLineCache(cache);
+  }
+  if (!cache.data) return missing;
+  if (cache.count == 0) return empty;
   
-  return "No facts available";
+  int target = random(0, cache.count);
+  const char* line = cache.data;
+  while (target-- > 0) {
+    line += strlen(line) + 1;
+  }
+  return String(line);
+}
+
+String loadQuoteOfDay() {
+  return randomCachedLine(quoteCache, "Believe you can and you're halfway there.", "No quotes available");
+}
+
+String loadFunFact() {
+  return randomCachedLine(factCache, "The ESP32 has built-in Wi-Fi and Bluetooth!", "No facts available");
 }
@@ -7,17 +7,28 @@
 
 // Content management functions
 void updateDisplayContent();
-void scrollText();
+void prepareNextContent(PreparedContent& item);
+
+// What the display is showing, for code off the display loop; the
+// sequence number changes whenever the item does
+uint32_t currentContentSeq();
+String currentContentText();
+bool scrollText();  // true when a scroll pass just finished
 void setScrollSpeed(uint8_t speed);
 void setScrollDirection(uint8_t direction);
 void addScrollContent(ContentType type, const String& content);
-void addRSSHeadline(const String& headline);
+void addRSSHeadline(const String& headline, time_t pubTime = 0, uint16_t feedId = 0,
+                    bool isNew = false, bool boosted = false);
 void clearRSSHeadlines();
+void clearFeedHeadlines(uint16_t feedId);
+void removeFeedHeadlines(uint16_t feedId);  // the feed left 'feeds'; also rebuilds the order
+void rebuildHeadlineOrder();
 
 // Content generation functions
 String generateTimeContent();
 String generateDateContent();
 String generateRSSContent();
+bool nextMarqueeHeadline(String& text, uint16_t& feedId, bool& wrapped);
 String loadQuoteOfDay();
 String loadFunFact();
 
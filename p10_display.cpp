@@ -4,11 +4,13 @@
 #include "p10_renderer.h"
 #include "p10_content.h"
 #include "p10_settings.h"
+#include "log.h"
 
 // Global display variables
 DisplaySettings displaySettings;
 std::vector<ScrollContent> scrollContents;
-std::vector<String> allRSSHeadlines;
+HeadlineStore allRSSHeadlines;
+std::vector<uint16_t> headlineOrder;
 
 void initializeP10Display() {
   // Initialize hardware
@@ -20,7 +22,16 @@ void initializeP10Display() {
   // Initialize scroll contents if empty
   initializeDefaultScrollContents();
   
-  Serial.printf("P10 Display initialized - Brightness: %d, Speed: %d\n",
+  applyLayout(static_cast<LayoutMode>(displaySettings.layout));
+  
+  // Sized once so rebuilding the rotation never allocates
+  allRSSHeadlines.reserve(MAX_RSS_HEADLINES + 1);
+  headlineOrder.reserve(MAX_RSS_HEADLINES + 1);
+  
+  // Prepare rotation items in the background from here on
+  startContentPrerender();
+  
+  LOG_INFO(DISPLAY, "P10 Display initialized - Brightness: %d, Speed: %d\n",
                 displaySettings.brightness, displaySettings.scrollSpeed);
   
   // Display initial test message
@@ -3,6 +3,9 @@
 #define P10_DISPLAY_H
 
 #include "config.h"
+#include "mem_policy.h"
+#include "p10_scheduler.h"
+#include "p10_preview.h"
 #include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
 
 // Display dimensions (configurable)
@@ -65,13 +68,15 @@ struct DisplaySettings {
   uint16_t textColor = 0xFFFF;  // White for RGB panels
   uint16_t backgroundColor = 0; // Black background
   uint16_t secondaryColor = 0xF800; // Red for effects
-  String currentContent = "";
   unsigned long lastScrollTime = 0;
   unsigned long lastAnimationTime = 0;
   int scrollPosition = 0;
   int animationStep = 0;
   bool scrollEnabled = true;
   bool animationEnabled = true;
+  bool marqueeMode = false;     // headlines as one continuous stream (left scroll only)
+  uint8_t layout = 0;           // LayoutMode: zones on the panel
+  uint8_t previewFps = PREVIEW_DEFAULT_FPS; // live preview frame rate in the web UI
 };
 
 // Content types for scrolling
@@ -84,21 +89,56 @@ enum ContentType {
   CONTENT_CUSTOM_TEXT = 5
 };
 
+// Clock items are shown for a fixed time; text items until they have
+// scrolled through once
+inline DwellPolicy defaultDwellPolicy(ContentType type) {
+  if (type == CONTENT_TIME || type == CONTENT_DATE) {
+    return {1, 5000, 5000, false};
+  }
+  return {1, 3000, 120000, true};
+}
+
 struct ScrollContent {
   ContentType type;
   String name;
   bool enabled;
   String content;
+  DwellPolicy schedule;
   
   ScrollContent(ContentType t, const String& n, bool e = true) 
-    : type(t), name(n), enabled(e) {}
+    : type(t), name(n), enabled(e), schedule(defaultDwellPolicy(t)) {}
+};
+
+// One ingested headline and where it came from
+struct RSSHeadline {
+  BulkText text;       // cold: read once per rotation, so it can sit in PSRAM
+  time_t pubTime;      // UTC seconds; undated items get when first seen, 0 if unknown
+  uint16_t feedId;     // RSSFeed::id of the source feed
+  bool isNew;          // first seen in the current fetch cycle
+  bool boosted;        // matched a boost keyword
+  
+  RSSHeadline(const String& t, time_t p, uint16_t f, bool n = false, bool b = false)
+    : text(t), pubTime(p), feedId(f), isNew(n), boosted(b) {}
+};
+
+typedef std::vector<RSSHeadline, BulkAllocator<RSSHeadline>> HeadlineStore;
+
+// One rotation item, generated and measured ahead of time
+struct PreparedContent {
+  String text;
+  int width = 0;                  // pixels in fontType
+  FontType fontType = FONT_MEDIUM;
+  int8_t contentIndex = -1;       // entry in scrollContents; -1 if none is enabled
+  bool marquee = false;           // headlines come from the marquee stream, not text
+  DwellPolicy schedule = {1, 0, 0, true};
 };
 
 // Global display variables
 extern DisplaySettings displaySettings;
 extern std::vector<ScrollContent> scrollContents;
-extern std::vector<String> allRSSHeadlines;
-extern MatrixPanel_I2S_DMA *dma_display;
+extern HeadlineStore allRSSHeadlines;              // grouped by feed, newest first
+extern std::vector<uint16_t> headlineOrder;        // rotation order into allRSSHeadlines
+extern ShadowedPanel *dma_display;
 
 // Main P10 display functions
 void initializeP10Display();
@@ -111,6 +151,9 @@ void setAnimationType(AnimationType animation);
 #include "p10_driver.h"
 #include "p10_renderer.h"
 #include "p10_content.h"
+#include "p10_prerender.h"
+#include "p10_marquee.h"
+#include "p10_compositor.h"
 #include "p10_settings.h"
 
 #endif
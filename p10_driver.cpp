@@ -1,11 +1,12 @@
 #include "p10_driver.h"
 #include "p10_display.h"
+#include "log.h"
 
 // Global matrix display object
-MatrixPanel_I2S_DMA *dma_display = nullptr;
+ShadowedPanel *dma_display = nullptr;
 
 void initializeP10Hardware() {
-  Serial.println("Initializing HUB75 LED Matrix Panel...");
+  LOG_INFO(DISPLAY, "Initializing HUB75 LED Matrix Panel...\n");
   
   // Configure the matrix panel
   HUB75_I2S_CFG mxconfig(
@@ -30,12 +31,12 @@ void initializeP10Hardware() {
   mxconfig.gpio.oe = OE_PIN;
   mxconfig.gpio.clk = CLK_PIN;
 
-  // Create the display object
-  dma_display = new MatrixPanel_I2S_DMA(mxconfig);
+  // Create the display object; it keeps a shadow copy for the web preview
+  dma_display = new ShadowedPanel(mxconfig, PANEL_RES_X * PANEL_CHAIN, PANEL_RES_Y);
   
   // Initialize the display
   if (!dma_display->begin()) {
-    Serial.println("ERROR: Could not initialize matrix display!");
+    LOG_ERROR(DISPLAY, "Could not initialize matrix display!\n");
     return;
   }
   
@@ -45,8 +46,8 @@ void initializeP10Hardware() {
   // Set initial brightness
   dma_display->setBrightness8(displaySettings.brightness * 255 / 100);
   
-  Serial.printf("HUB75 Matrix initialized - Resolution: %dx%d\n", PANEL_RES_X, PANEL_RES_Y);
-  Serial.printf("Panel type: %s\n", displaySettings.panelType == PANEL_RGB ? "RGB" : "Mono");
+  LOG_INFO(DISPLAY, "HUB75 Matrix initialized - Resolution: %dx%d\n", PANEL_RES_X, PANEL_RES_Y);
+  LOG_INFO(DISPLAY, "Panel type: %s\n", displaySettings.panelType == PANEL_RGB ? "RGB" : "Mono");
 }
 
 void clearDisplayBuffer() {
@@ -60,7 +61,7 @@ void setDisplayBrightness(uint8_t brightness) {
   if (dma_display) {
     dma_display->setBrightness8(displaySettings.brightness * 255 / 100);
   }
-  Serial.printf("Display brightness set to: %d%%\n", displaySettings.brightness);
+  LOG_INFO(DISPLAY, "Display brightness set to: %d%%\n", displaySettings.brightness);
 }
 
 void setPanelType(PanelType type) {
@@ -77,17 +78,17 @@ void setPanelType(PanelType type) {
     displaySettings.secondaryColor = 0xF800; // Red
   }
   
-  Serial.printf("Panel type set to: %s\n", type == PANEL_RGB ? "RGB" : "Mono");
+  LOG_INFO(DISPLAY, "Panel type set to: %s\n", type == PANEL_RGB ? "RGB" : "Mono");
 }
 
 void setFontType(FontType font) {
   displaySettings.fontType = font;
-  Serial.printf("Font type set to: %d\n", font);
+  LOG_INFO(DISPLAY, "Font type set to: %d\n", font);
 }
 
 void setAnimationType(AnimationType animation) {
   displaySettings.animationType = animation;
   displaySettings.animationStep = 0;
   displaySettings.lastAnimationTime = millis();
-  Serial.printf("Animation type set to: %d\n", animation);
+  LOG_INFO(DISPLAY, "Animation type set to: %d\n", animation);
 }
\ No newline at end of file
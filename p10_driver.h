@@ -13,6 +13,6 @@ void setFontType(FontType font);
 void setAnimationType(AnimationType animation);
 
 // Hardware variables
-extern MatrixPanel_I2S_DMA *dma_display;
+extern ShadowedPanel *dma_display;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "p10_marquee.h"
+#include "p10_content.h"
+#include "p10_compositor.h"
+
+// Separator glyph; a diamond in the built-in GFX font
+#define MARQUEE_ICON "\x04"
+
+struct MarqueeTile {
+  GFXcanvas1* canvas;
+  uint16_t color;
+  uint8_t width;   // columns in use, up to MARQUEE_TILE_WIDTH
+  bool passStart;  // first tile of a new pass through the rotation
+};
+
+static MarqueeTile tiles[MARQUEE_TILES];
+static uint8_t head = 0;    // leftmost tile
+static uint8_t count = 0;
+static int16_t headX = 0;   // x of the head tile within the ticker zone
+
+// The segment being rasterized: a separator or a headline
+static String segText;
+static uint16_t segColor = 0;
+static int32_t segWidth = 0;
+static int32_t segOffset = 0;  // pixels already rasterized
+static bool segPassStart = false;
+
+// Headline fetched along with its separator, shown after it
+static String nextHeadline;
+static bool haveNextHeadline = false;
+
+static uint8_t marqueeTextSize() {
+  return displaySettings.fontType == FONT_LARGE ? 2 : 1;
+}
+
+static uint16_t marqueeTextColor() {
+  // Same rule as drawText(): mono panels only have red
+  return displaySettings.panelType == PANEL_MONO ? 0xF800 : displaySettings.textColor;
+}
+
+static void setSegment(const String& text, uint16_t color, bool passStart) {
+  segText = text;
+  segColor = color;
+  segWidth = static_cast<int32_t>(text.length()) * 6 * marqueeTextSize();
+  segOffset = 0;
+  segPassStart = passStart;
+}
+
+// Moves on to the next segment. False if the headline store is busy.
+static bool loadNextSegment() {
+  if (haveNextHeadline) {
+    haveNextHeadline = false;
+    setSegment(nextHeadline, marqueeTextColor(), false);
+    nextHeadline = String();
+    return true;
+  }
+  
+  uint16_t feedId;
+  bool wrapped;
+  if (!nextMarqueeHeadline(nextHeadline, feedId, wrapped)) {
+    return false;
+  }
+  haveNextHeadline = true;
+  
+  // Name the source feed; just the icon if it can't be looked up right now
+  String separator = "  " MARQUEE_ICON " ";
+  if (feedId < UINT16_MAX && tryLockFeeds()) {
+    int index = findFeedIndex(feedId);
+    if (index >= 0) {
+      separator += feeds[index].name + " " MARQUEE_ICON " ";
+    }
+    unlockFeeds();
+  }
+  separator += " ";
+  setSegment(separator, displaySettings.secondaryColor, wrapped);
+  return true;
+}
+
+// Rasterizes the next slice of the stream into a free tile
+static void fillTile(MarqueeTile& tile) {
+  tile.canvas->fillScreen(0);
+  tile.passStart = false;
+  
+  if (segOffset >= segWidth && !loadNextSegment()) {
+    // Store busy: leave a short gap rather than wait
+    tile.color = 0;
+    tile.width = MARQUEE_TILE_WIDTH / 4;
+    return;
+  }
+  
+  tile.passStart = segOffset == 0 && segPassStart;
+  tile.color = segColor;
+  tile.width = min(static_cast<int32_t>(MARQUEE_TILE_WIDTH), segWidth - segOffset);
+  
+  // Only the characters that overlap this tile
+  uint8_t size = marqueeTextSize();
+  int advance = 6 * size;
+  size_t first = segOffset / advance;
+  tile.canvas->setTextSize(size);
+  tile.canvas->setTextWrap(false);
+  tile.canvas->setTextColor(1);
+  tile.canvas->setCursor(first * advance - segOffset, 0);
+  for (size_t i = first; i < segText.length(); i++) {
+    if (static_cast<int32_t>(i * advance) - segOffset >= tile.width) break;
+    tile.canvas->write(segText[i]);
+  }
+  
+  segOffset += tile.width;
+}
+
+// Keeps one tile of lookahead rasterized past the right edge
+static void fillRing() {
+  int16_t right = headX;
+  for (uint8_t i = 0; i < count; i++) {
+    right += tiles[(head + i) % MARQUEE_TILES].width;
+  }
+  while (count < MARQUEE_TILES && right < tickerZone().w + MARQUEE_TILE_WIDTH) {
+    MarqueeTile& tile = tiles[(head + count) % MARQUEE_TILES];
+    fillTile(tile);
+    right += tile.width;
+    count++;
+  }
+}
+
+void marqueeBegin() {
+  if (!tiles[0].canvas) {
+    for (int i = 0; i < MARQUEE_TILES; i++) {
+      tiles[i].canvas = new GFXcanvas1(MARQUEE_TILE_WIDTH, MARQUEE_TILE_HEIGHT);
+    }
+  }
+  
+  // Tiles not yet shown are dropped, so redo the segment they came from
+  head = 0;
+  count = 0;
+  headX = tickerZone().w;
+  segOffset = 0;
+  fillRing();
+}
+
+bool marqueeStep() {
+  if (!tiles[0].canvas) {
+    marqueeBegin();
+  }
+  
+  bool passComplete = false;
+  headX--;
+  if (headX + tiles[head].width <= 0) {
+    headX += tiles[head].width;
+    head = (head + 1) % MARQUEE_TILES;
+    count--;
+    passComplete = tiles[head].passStart;
+  }
+  fillRing();
+  
+  if (dma_display) {
+    const DisplayZone& zone = tickerZone();
+    clearZone(zone);
+    int16_t x = zone.x + headX;
+    int16_t y = zone.y + (zone.h - 8 * marqueeTextSize()) / 2;
+    for (uint8_t i = 0; i < count && x < zone.x + zone.w; i++) {
+      const MarqueeTile& tile = tiles[(head + i) % MARQUEE_TILES];
+      if (tile.color) {
+        dma_display->drawBitmap(x, y, tile.canvas->getBuffer(), MARQUEE_TILE_WIDTH, MARQUEE_TILE_HEIGHT, tile.color);
+      }
+      x += tile.width;
+    }
+  }
+  
+  displaySettings.lastScrollTime = millis();
+  return passComplete;
+}
@@ -0,0 +1,32 @@
+#ifndef P10_MARQUEE_H
+#define P10_MARQUEE_H
+
+#include <Arduino.h>
+#include "p10_display.h"
+
+// Continuous marquee: the whole headline rotation as one stream,
+//   ... headline  * BBC World *  headline  * Reuters *  ...
+// with no empty screen between items.
+//
+// The stream is rasterized lazily into a small ring of 1-bit tiles that
+// covers the viewport plus one tile of lookahead; a segment's last tile
+// is usually narrow, hence the spare slots. Only the
+// headline being rasterized is held as text, so memory depends on the
+// viewport, not on how long the headlines are or how many there are.
+
+#define MARQUEE_TILE_WIDTH 32
+#define MARQUEE_TILE_HEIGHT 16  // FONT_LARGE is the tallest at 16 px
+#define MARQUEE_TILES (DISPLAY_WIDTH / MARQUEE_TILE_WIDTH + 4)
+
+// Rough pixels per headline plus separator, to estimate a full pass
+#define MARQUEE_EST_ITEM_PX 320
+
+// Start (or restart) drawing from an empty screen; the stream itself
+// carries on from the current rotation position
+void marqueeBegin();
+
+// Advance one pixel and draw. True when the first headline of a new
+// pass through the rotation has reached the left edge.
+bool marqueeStep();
+
+#endif
@@ -0,0 +1,64 @@
+#include "p10_prerender.h"
+#include "p10_content.h"
+#include "log.h"
+
+static PreparedContent slots[2];
+static uint8_t backSlot = 0;  // the slot the task fills next
+
+static QueueHandle_t prepQueue = nullptr;   // millis() to start preparing
+static QueueHandle_t readyQueue = nullptr;  // finished PreparedContent*
+static TaskHandle_t prepTask = nullptr;
+
+static void contentPrepTask(void* parameter) {
+  unsigned long prepareAt;
+  
+  for (;;) {
+    xQueueReceive(prepQueue, &prepareAt, portMAX_DELAY);
+    
+    // Drop a hurry meant for the previous item, then wait unless hurried
+    ulTaskNotifyTake(pdTRUE, 0);
+    long wait = static_cast<long>(prepareAt - millis());
+    if (wait > 0) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+    }
+    
+    PreparedContent* item = &slots[backSlot];
+    prepareNextContent(*item);
+    // An empty result is dropped by the display, so its slot is reused
+    if (item->contentIndex >= 0) {
+      backSlot ^= 1;
+    }
+    xQueueSend(readyQueue, &item, portMAX_DELAY);
+  }
+}
+
+void startContentPrerender() {
+  if (prepQueue) return;
+  
+  prepQueue = xQueueCreate(1, sizeof(unsigned long));
+  readyQueue = xQueueCreate(1, sizeof(PreparedContent*));
+  xTaskCreate(contentPrepTask, "Content_Prep", 4096, NULL, 1, &prepTask);
+  
+  // First item right away
+  requestNextContent(millis());
+  LOG_INFO(DISPLAY, "Content prerender task started\n");
+}
+
+PreparedContent* takePreparedContent() {
+  PreparedContent* item = nullptr;
+  if (!readyQueue || xQueueReceive(readyQueue, &item, 0) != pdTRUE) {
+    return nullptr;
+  }
+  return item;
+}
+
+void requestNextContent(unsigned long prepareAt) {
+  if (!prepQueue) return;
+  xQueueSend(prepQueue, &prepareAt, 0);
+}
+
+void hurryNextContent() {
+  if (prepTask) {
+    xTaskNotifyGive(prepTask);
+  }
+}
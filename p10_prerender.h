@@ -0,0 +1,32 @@
+#ifndef P10_PRERENDER_H
+#define P10_PRERENDER_H
+
+#include <Arduino.h>
+#include "p10_display.h"
+
+// Content lookahead. A background task prepares the next rotation item
+// (picks it, generates the text, measures it) while the current one
+// scrolls, so the switch on the display loop is just a pointer swap.
+// Two slots: the one on screen and the one being prepared.
+
+// The next item is prepared this long before it is expected, so clock
+// text is still current when it appears
+#define CONTENT_PREP_LEAD_MS 300
+// Retry interval while no content type is enabled
+#define CONTENT_IDLE_RETRY_MS 1000
+
+void startContentPrerender();
+
+// The prepared item, or nullptr if it isn't ready yet. The caller owns
+// it until the next requestNextContent().
+PreparedContent* takePreparedContent();
+
+// Start on the item after; the slot it fills is the one shown before
+// the last take, so only call this once that item is off screen.
+void requestNextContent(unsigned long prepareAt);
+
+// The item on screen finished earlier than expected: prepare the
+// requested one now instead of at its prepareAt
+void hurryNextContent();
+
+#endif
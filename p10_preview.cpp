@@ -0,0 +1,148 @@
+#include "p10_preview.h"
+#include "p10_display.h"
+#include "mem_policy.h"
+#include "log.h"
+
+PreviewStats previewStats = {0, 0, 0, 0, 0, 0, 0};
+
+static PreviewReadyFn sinkReady = nullptr;
+static PreviewSendFn sinkSend = nullptr;
+static volatile uint8_t watchers = 0;
+static volatile bool keyframePending = true;
+
+// Last frame sent and the encode buffer; only held while someone watches
+static uint16_t* sentFrame = nullptr;
+static uint8_t* encodeBuffer = nullptr;
+static size_t encodeCapacity = 0;
+static uint16_t frameSeq = 0;
+static unsigned long lastPreviewTime = 0;
+
+ShadowedPanel::ShadowedPanel(const HUB75_I2S_CFG& config, uint16_t width, uint16_t height)
+  : MatrixPanel_I2S_DMA(config), frameWidth(width), frameHeight(height) {
+  // Written for every pixel drawn, so it stays in internal RAM
+  frame = static_cast<uint16_t*>(memAlloc(width * height * sizeof(uint16_t), ALLOC_HOT));
+  if (frame) {
+    memset(frame, 0, width * height * sizeof(uint16_t));
+  }
+}
+
+void ShadowedPanel::shadowRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (!frame) return;
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > frameWidth) w = frameWidth - x;
+  if (y + h > frameHeight) h = frameHeight - y;
+  if (w <= 0 || h <= 0) return;
+  
+  for (int16_t row = y; row < y + h; row++) {
+    uint16_t* p = frame + row * frameWidth + x;
+    for (int16_t i = 0; i < w; i++) p[i] = color;
+  }
+}
+
+void ShadowedPanel::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (frame && x >= 0 && y >= 0 && x < frameWidth && y < frameHeight) {
+    frame[y * frameWidth + x] = color;
+  }
+  MatrixPanel_I2S_DMA::drawPixel(x, y, color);
+}
+
+void ShadowedPanel::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  shadowRect(x, y, w, h, color);
+  MatrixPanel_I2S_DMA::fillRect(x, y, w, h, color);
+}
+
+void ShadowedPanel::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  shadowRect(x, y, w, 1, color);
+  MatrixPanel_I2S_DMA::drawFastHLine(x, y, w, color);
+}
+
+void ShadowedPanel::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  shadowRect(x, y, 1, h, color);
+  MatrixPanel_I2S_DMA::drawFastVLine(x, y, h, color);
+}
+
+void ShadowedPanel::fillScreen(uint16_t color) {
+  shadowRect(0, 0, frameWidth, frameHeight, color);
+  MatrixPanel_I2S_DMA::fillScreen(color);
+}
+
+void ShadowedPanel::clearScreen() {
+  shadowRect(0, 0, frameWidth, frameHeight, 0);
+  MatrixPanel_I2S_DMA::clearScreen();
+}
+
+void setPreviewSink(PreviewReadyFn ready, PreviewSendFn send) {
+  sinkReady = ready;
+  sinkSend = send;
+}
+
+void setPreviewWatchers(uint8_t count) {
+  watchers = count;
+}
+
+void requestPreviewKeyframe() {
+  keyframePending = true;
+}
+
+static void releasePreviewBuffers() {
+  memFree(sentFrame);
+  memFree(encodeBuffer);
+  sentFrame = nullptr;
+  encodeBuffer = nullptr;
+  encodeCapacity = 0;
+}
+
+void previewFrameDone() {
+  if (watchers == 0) {
+    // Buffers are freed here rather than on disconnect so only this task
+    // ever touches them
+    if (encodeBuffer) releasePreviewBuffers();
+    return;
+  }
+  if (!dma_display || !dma_display->shadow() || !sinkReady || !sinkSend) return;
+  
+  uint8_t fps = constrain(displaySettings.previewFps, 1, PREVIEW_MAX_FPS);
+  unsigned long now = millis();
+  if (now - lastPreviewTime < 1000UL / fps) return;
+  lastPreviewTime = now;
+  
+  if (!sinkReady()) {
+    previewStats.skippedBusy++;
+    return;
+  }
+  
+  uint8_t width = dma_display->shadowWidth();
+  uint8_t height = dma_display->shadowHeight();
+  if (!encodeBuffer) {
+    encodeCapacity = PREVIEW_MAX_FRAME_BYTES(width, height);
+    sentFrame = static_cast<uint16_t*>(memAlloc(width * height * sizeof(uint16_t), ALLOC_BULK));
+    encodeBuffer = static_cast<uint8_t*>(memAlloc(encodeCapacity, ALLOC_BULK));
+    if (!sentFrame || !encodeBuffer) {
+      LOG_WARN(DISPLAY, "Preview: no memory for %u byte frame buffers\n", encodeCapacity);
+      releasePreviewBuffers();
+      return;
+    }
+    keyframePending = true;
+  }
+  
+  bool keyframe = keyframePending;
+  keyframePending = false;
+  
+  unsigned long start = micros();
+  size_t len = encodePreviewFrame(dma_display->shadow(), sentFrame, width, height,
+                                  keyframe, frameSeq, encodeBuffer, encodeCapacity);
+  uint32_t elapsed = micros() - start;
+  
+  previewStats.lastEncodeUs = elapsed;
+  if (elapsed > previewStats.maxEncodeUs) previewStats.maxEncodeUs = elapsed;
+  previewStats.avgEncodeUs = (previewStats.avgEncodeUs * 7 + elapsed) / 8;
+  
+  if (len == 0) return;  // nothing changed
+  
+  sinkSend(encodeBuffer, len);
+  frameSeq++;
+  previewStats.frames++;
+  previewStats.bytes += len;
+  if (keyframe) previewStats.keyframes++;
+}
@@ -0,0 +1,69 @@
+#ifndef P10_PREVIEW_H
+#define P10_PREVIEW_H
+
+#include <Arduino.h>
+#include <ESP32-HUB75-MatrixPanel-I2S-DMA.h>
+#include "p10_preview_codec.h"
+
+// Live preview of the panel for the web UI.
+//
+// The DMA buffer holds bit planes that can't be read back as pixels, so
+// the panel object keeps an RGB565 shadow of everything drawn on it.
+// After each display loop pass the changed rows of the shadow are
+// run-length encoded and handed to the web side, throttled to
+// displaySettings.previewFps and only while someone is watching.
+
+#define PREVIEW_DEFAULT_FPS 5
+#define PREVIEW_MAX_FPS 20
+
+// Matrix panel that mirrors every pixel it draws into a shadow frame
+class ShadowedPanel : public MatrixPanel_I2S_DMA {
+public:
+  ShadowedPanel(const HUB75_I2S_CFG& config, uint16_t width, uint16_t height);
+  
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  void clearScreen();
+  
+  const uint16_t* shadow() const { return frame; }
+  uint16_t shadowWidth() const { return frameWidth; }
+  uint16_t shadowHeight() const { return frameHeight; }
+
+private:
+  void shadowRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  
+  uint16_t* frame;  // nullptr if it could not be allocated
+  uint16_t frameWidth;
+  uint16_t frameHeight;
+};
+
+struct PreviewStats {
+  uint32_t frames;
+  uint32_t keyframes;
+  uint32_t bytes;
+  uint32_t skippedBusy;    // frames dropped because a client was still sending
+  uint32_t lastEncodeUs;
+  uint32_t maxEncodeUs;
+  uint32_t avgEncodeUs;    // moving average
+};
+
+extern PreviewStats previewStats;
+
+// Where encoded frames go. ready() is asked before encoding, so a
+// backed-up client costs nothing on the render core.
+typedef bool (*PreviewReadyFn)();
+typedef void (*PreviewSendFn)(const uint8_t* data, size_t len);
+
+void setPreviewSink(PreviewReadyFn ready, PreviewSendFn send);
+
+// From the web side: number of watchers; a new watcher gets a keyframe
+void setPreviewWatchers(uint8_t count);
+void requestPreviewKeyframe();
+
+// Called by the display loop once the frame is drawn
+void previewFrameDone();
+
+#endif
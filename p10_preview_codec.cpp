@@ -0,0 +1,51 @@
+#include "p10_preview_codec.h"
+#include <string.h>
+
+// Runs for one row; returns bytes written, or 0 if they don't fit
+static size_t encodeRow(const uint16_t* row, uint8_t width, uint8_t* out, size_t capacity) {
+  size_t n = 0;
+  uint8_t x = 0;
+  while (x < width) {
+    uint16_t color = row[x];
+    uint8_t count = 1;
+    while (x + count < width && row[x + count] == color) count++;
+    
+    if (n + 3 > capacity) return 0;
+    out[n++] = count;
+    out[n++] = color & 0xFF;
+    out[n++] = color >> 8;
+    x += count;
+  }
+  return n;
+}
+
+size_t encodePreviewFrame(const uint16_t* frame, uint16_t* sent,
+                          uint8_t width, uint8_t height,
+                          bool keyframe, uint16_t seq,
+                          uint8_t* out, size_t capacity) {
+  if (capacity < PREVIEW_HEADER_BYTES) return 0;
+  
+  out[0] = PREVIEW_MAGIC;
+  out[1] = keyframe ? PREVIEW_FLAG_KEYFRAME : 0;
+  out[2] = width;
+  out[3] = height;
+  out[4] = seq & 0xFF;
+  out[5] = seq >> 8;
+  size_t n = PREVIEW_HEADER_BYTES;
+  
+  size_t rowBytes = width * sizeof(uint16_t);
+  for (uint8_t y = 0; y < height; y++) {
+    const uint16_t* row = frame + y * width;
+    uint16_t* last = sent + y * width;
+    if (!keyframe && memcmp(row, last, rowBytes) == 0) continue;
+    
+    if (n + 1 > capacity) return 0;
+    out[n++] = y;
+    size_t runs = encodeRow(row, width, out + n, capacity - n);
+    if (runs == 0) return 0;
+    n += runs;
+    memcpy(last, row, rowBytes);
+  }
+  
+  return n > PREVIEW_HEADER_BYTES ? n : 0;
+}
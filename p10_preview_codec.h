@@ -0,0 +1,33 @@
+#ifndef P10_PREVIEW_CODEC_H
+#define P10_PREVIEW_CODEC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Wire format of the live preview stream, kept free of Arduino calls so
+// the encoder can be built and timed on the host.
+//
+// Frame (little-endian):
+//   'P', flags, width, height, seq(u16)    flags bit 0: keyframe
+//   then for each row that changed (every row in a keyframe):
+//     row(u8), runs...                     runs cover exactly 'width' pixels
+//   run: count(u8), color(u16, RGB565)
+//
+// A frame with no changed rows is not sent at all.
+
+#define PREVIEW_MAGIC 'P'
+#define PREVIEW_FLAG_KEYFRAME 0x01
+#define PREVIEW_HEADER_BYTES 6
+
+// Largest possible frame: every row changed, every pixel its own run
+#define PREVIEW_MAX_FRAME_BYTES(w, h) (PREVIEW_HEADER_BYTES + (h) * (1 + 3 * (w)))
+
+// Encodes the rows of 'frame' that differ from 'sent' (all rows when
+// keyframe is set) into 'out', and copies them into 'sent'. Returns the
+// frame size, or 0 when nothing changed or 'out' is too small.
+size_t encodePreviewFrame(const uint16_t* frame, uint16_t* sent,
+                          uint8_t width, uint8_t height,
+                          bool keyframe, uint16_t seq,
+                          uint8_t* out, size_t capacity);
+
+#endif
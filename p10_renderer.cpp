@@ -1,6 +1,7 @@
 #include "p10_renderer.h"
 #include "p10_display.h"
 #include "p10_driver.h"
+#include "log.h"
 
 // Font size configurations
 struct FontConfig {
@@ -52,7 +53,7 @@ void drawText(const String& text, int x, int y) {
   dma_display->setCursor(x, y);
   dma_display->print(text);
   
-  Serial.printf("Drew text: '%s' at (%d,%d) with color 0x%04X\n", text.c_str(), x, y, color);
+  LOG_TRACE(DISPLAY, "Drew text: '%s' at (%d,%d) with color 0x%04X\n", text.c_str(), x, y, color);
 }
 
 void drawTextWithAnimation(const String& text, int x, int y) {
@@ -0,0 +1,76 @@
+#include "p10_scheduler.h"
+
+bool dwellInRange(uint32_t minDwellMs, uint32_t maxDwellMs) {
+  if (minDwellMs < DWELL_MIN_MS || minDwellMs > DWELL_MAX_MS) return false;
+  return maxDwellMs == 0 || (maxDwellMs >= minDwellMs && maxDwellMs <= DWELL_MAX_MS);
+}
+
+void clampDwell(DwellPolicy& policy) {
+  if (policy.minDwellMs < DWELL_MIN_MS) policy.minDwellMs = DWELL_MIN_MS;
+  if (policy.minDwellMs > DWELL_MAX_MS) policy.minDwellMs = DWELL_MAX_MS;
+  if (policy.maxDwellMs > DWELL_MAX_MS) policy.maxDwellMs = DWELL_MAX_MS;
+  if (policy.maxDwellMs != 0 && policy.maxDwellMs < policy.minDwellMs) {
+    policy.maxDwellMs = policy.minDwellMs;
+  }
+}
+
+int WeightedRotation::pickNext(const uint8_t* weights, size_t count) {
+  if (count > SCHEDULER_MAX_ITEMS) count = SCHEDULER_MAX_ITEMS;
+  
+  int32_t total = 0;
+  int best = -1;
+  for (size_t i = 0; i < count; i++) {
+    if (weights[i] == 0) {
+      current[i] = 0;
+      continue;
+    }
+    current[i] += weights[i];
+    total += weights[i];
+    if (best < 0 || current[i] > current[best]) {
+      best = i;
+    }
+  }
+  
+  if (best >= 0) {
+    current[best] -= total;
+  }
+  return best;
+}
+
+void WeightedRotation::reset() {
+  for (size_t i = 0; i < SCHEDULER_MAX_ITEMS; i++) {
+    current[i] = 0;
+  }
+}
+
+void DwellTracker::begin(const DwellPolicy& p, uint32_t now, uint32_t scrollMs) {
+  policy = p;
+  shownAt = now;
+  
+  // Static and timed items have nothing to wait for past the minimum
+  if (!policy.advanceOnComplete || scrollMs == 0) {
+    limitMs = policy.minDwellMs;
+    hasLimit = true;
+    expectedMs = policy.minDwellMs;
+    return;
+  }
+  
+  limitMs = policy.maxDwellMs;
+  hasLimit = policy.maxDwellMs > 0;
+  
+  // The first pass that ends after the minimum dwell
+  uint32_t passes = (policy.minDwellMs + scrollMs - 1) / scrollMs;
+  if (passes == 0) passes = 1;
+  expectedMs = passes * scrollMs;
+  if (hasLimit && expectedMs > limitMs) {
+    expectedMs = limitMs;
+  }
+}
+
+bool DwellTracker::onScrollComplete(uint32_t now) const {
+  return policy.advanceOnComplete && now - shownAt >= policy.minDwellMs;
+}
+
+bool DwellTracker::due(uint32_t now) const {
+  return hasLimit && now - shownAt >= limitMs;
+}
@@ -0,0 +1,72 @@
+#ifndef P10_SCHEDULER_H
+#define P10_SCHEDULER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Content rotation decisions, kept free of Arduino and FreeRTOS calls:
+// time is always passed in, so the logic runs the same against a
+// virtual clock on the host.
+//
+// WeightedRotation picks which item comes next; DwellTracker decides when
+// the item on screen is done. Items normally advance when the scroll
+// engine reports a finished pass, bounded by a minimum and maximum dwell.
+
+#define SCHEDULER_MAX_ITEMS 16
+
+// Accepted dwell times; a maximum of 0 means no limit
+#define DWELL_MIN_MS 500
+#define DWELL_MAX_MS 600000
+
+// How one content type takes part in the rotation
+struct DwellPolicy {
+  uint8_t weight;          // share of rotation slots; 0 leaves it out
+  uint32_t minDwellMs;     // never switch away sooner
+  uint32_t maxDwellMs;     // switch even mid-scroll; 0 = no limit
+  bool advanceOnComplete;  // false: switch at minDwellMs regardless of scrolling
+};
+
+// True if the pair is within the accepted range and the maximum, when
+// set, is not below the minimum
+bool dwellInRange(uint32_t minDwellMs, uint32_t maxDwellMs);
+
+// Pulls a policy loaded from elsewhere back into range
+void clampDwell(DwellPolicy& policy);
+
+// Smooth weighted round-robin: every pick, each item gains its weight,
+// the highest goes next and pays back the total. Weights 3/1/1 give
+// A B A C A rather than A A A B C.
+class WeightedRotation {
+public:
+  // weights[i] == 0 means item i is disabled. Returns -1 if none is enabled.
+  int pickNext(const uint8_t* weights, size_t count);
+  void reset();
+
+private:
+  int32_t current[SCHEDULER_MAX_ITEMS] = {};
+};
+
+class DwellTracker {
+public:
+  // The item went on screen. scrollMs is one full pass, 0 if it fits
+  // without scrolling.
+  void begin(const DwellPolicy& policy, uint32_t now, uint32_t scrollMs);
+  
+  // The scroll engine finished a pass; true means switch now
+  bool onScrollComplete(uint32_t now) const;
+  
+  // A dwell limit has passed; true means switch now
+  bool due(uint32_t now) const;
+  
+  // Best guess of when the switch happens, for preparing the next item
+  uint32_t expectedEnd() const { return shownAt + expectedMs; }
+
+private:
+  DwellPolicy policy = {1, 0, 0, true};
+  uint32_t shownAt = 0;
+  uint32_t limitMs = 0;     // time on screen after which due() fires
+  bool hasLimit = false;
+  uint32_t expectedMs = 0;
+};
+
+#endif
@@ -1,6 +1,8 @@
 
 #include "p10_settings.h"
 #include "p10_display.h"
+#include "log.h"
+#include "config_store.h"
 
 // Default scroll contents
 const std::vector<ScrollContent> DEFAULT_SCROLL_CONTENTS = {
@@ -11,20 +13,14 @@ const std::vector<ScrollContent> DEFAULT_SCROLL_CONTENTS = {
   {CONTENT_FUN_FACTS, "Fun Facts", false}
 };
 
-void loadDisplaySettings() {
-  File file = SPIFFS.open("/display.json", "r");
-  if (!file) {
-    Serial.println("Display settings file not found - using defaults");
-    return;
-  }
-  
-  DynamicJsonDocument doc(1024);
-  DeserializationError error = deserializeJson(doc, file);
-  file.close();
+// Reads /display.json from before the binary format
+static bool importDisplayConfig(char* data, size_t len) {
+  DynamicJsonDocument doc(2048);
+  DeserializationError error = deserializeJson(doc, data, len);
   
   if (error) {
-    Serial.println("Failed to parse display settings");
-    return;
+    LOG_ERROR(DISPLAY, "Failed to parse display settings\n");
+    return false;
   }
   
   displaySettings.brightness = doc["brightness"] | 50;
@@ -38,6 +34,9 @@ void loadDisplaySettings() {
   displaySettings.secondaryColor = doc["secondaryColor"] | 0xF800;
   displaySettings.scrollEnabled = doc["scrollEnabled"] | true;
   displaySettings.animationEnabled = doc["animationEnabled"] | true;
+  displaySettings.marqueeMode = doc["marqueeMode"] | false;
+  displaySettings.layout = doc["layout"] | LAYOUT_SINGLE;
+  displaySettings.previewFps = doc["previewFps"] | PREVIEW_DEFAULT_FPS;
   
   if (doc.containsKey("scrollContents")) {
     scrollContents.clear();
@@ -51,51 +50,119 @@ void loadDisplaySettings() {
       
       ScrollContent sc(type, name, enabled);
       sc.content = contentText;
+      sc.schedule.weight = content["weight"] | sc.schedule.weight;
+      sc.schedule.minDwellMs = content["minDwell"] | sc.schedule.minDwellMs;
+      sc.schedule.maxDwellMs = content["maxDwell"] | sc.schedule.maxDwellMs;
+      sc.schedule.advanceOnComplete = content["advanceOnComplete"] | sc.schedule.advanceOnComplete;
+      clampDwell(sc.schedule);
       scrollContents.push_back(sc);
     }
   }
   
-  Serial.println("Display settings loaded successfully");
+  LOG_INFO(DISPLAY, "Display settings loaded successfully\n");
+  return true;
 }
 
-void saveDisplaySettings() {
-  File file = SPIFFS.open("/display.json", "w");
-  if (!file) {
-    Serial.println("Failed to open display settings for writing");
-    return;
-  }
+static bool decodeDisplayConfig(ConfigReader& in) {
+  DisplaySettings loaded;
+  loaded.brightness = in.u8();
+  loaded.scrollSpeed = in.u8();
+  loaded.scrollDirection = in.u8();
+  loaded.panelType = static_cast<PanelType>(in.u8());
+  loaded.fontType = static_cast<FontType>(in.u8());
+  loaded.animationType = static_cast<AnimationType>(in.u8());
+  loaded.textColor = in.u16();
+  loaded.backgroundColor = in.u16();
+  loaded.secondaryColor = in.u16();
+  loaded.scrollEnabled = in.u8();
+  loaded.animationEnabled = in.u8();
+  loaded.marqueeMode = in.u8();
+  loaded.layout = in.u8();
+  loaded.previewFps = in.u8();
   
-  DynamicJsonDocument doc(2048);
-  doc["brightness"] = displaySettings.brightness;
-  doc["scrollSpeed"] = displaySettings.scrollSpeed;
-  doc["scrollDirection"] = displaySettings.scrollDirection;
-  doc["panelType"] = static_cast<int>(displaySettings.panelType);
-  doc["fontType"] = static_cast<int>(displaySettings.fontType);
-  doc["animationType"] = static_cast<int>(displaySettings.animationType);
-  doc["textColor"] = displaySettings.textColor;
-  doc["backgroundColor"] = displaySettings.backgroundColor;
-  doc["secondaryColor"] = displaySettings.secondaryColor;
-  doc["scrollEnabled"] = displaySettings.scrollEnabled;
-  doc["animationEnabled"] = displaySettings.animationEnabled;
+  uint8_t count = in.u8();
+  std::vector<ScrollContent> contents;
+  contents.reserve(count);
+  for (uint8_t i = 0; i < count && !in.failed(); i++) {
+    ContentType type = static_cast<ContentType>(in.u8());
+    ScrollContent sc(type, "", in.u8());
+    sc.schedule.weight = in.u8();
+    sc.schedule.advanceOnComplete = in.u8();
+    sc.schedule.minDwellMs = in.u32();
+    sc.schedule.maxDwellMs = in.u32();
+    clampDwell(sc.schedule);
+    in.str(sc.name);
+    in.str(sc.content);
+    contents.push_back(sc);
+  }
+  if (in.failed()) return false;
   
-  JsonArray contents = doc.createNestedArray("scrollContents");
-  for (const auto& content : scrollContents) {
-    JsonObject obj = contents.createNestedObject();
-    obj["type"] = static_cast<int>(content.type);
-    obj["name"] = content.name;
-    obj["enabled"] = content.enabled;
-    obj["content"] = content.content;
+  displaySettings = loaded;
+  scrollContents.swap(contents);
+  LOG_INFO(DISPLAY, "Display settings loaded successfully\n");
+  return true;
+}
+
+void loadDisplaySettings() {
+  if (!loadConfigFile(CONFIG_DISPLAY, decodeDisplayConfig, importDisplayConfig)) {
+    LOG_WARN(DISPLAY, "Display settings file not found - using defaults\n");
   }
+}
+
+static SemaphoreHandle_t displaySettingsMutex = xSemaphoreCreateMutex();
+
+void lockDisplaySettings() {
+  xSemaphoreTake(displaySettingsMutex, portMAX_DELAY);
+}
+
+void unlockDisplaySettings() {
+  xSemaphoreGive(displaySettingsMutex);
+}
+
+void encodeDisplayConfig(ConfigWriter& out) {
+  // Web edits may run while this writes, so work from a snapshot
+  lockDisplaySettings();
+  DisplaySettings current = displaySettings;
+  std::vector<ScrollContent> contents = scrollContents;
+  unlockDisplaySettings();
   
-  size_t bytesWritten = serializeJson(doc, file);
-  file.close();
+  out.u8(current.brightness);
+  out.u8(current.scrollSpeed);
+  out.u8(current.scrollDirection);
+  out.u8(current.panelType);
+  out.u8(current.fontType);
+  out.u8(current.animationType);
+  out.u16(current.textColor);
+  out.u16(current.backgroundColor);
+  out.u16(current.secondaryColor);
+  out.u8(current.scrollEnabled);
+  out.u8(current.animationEnabled);
+  out.u8(current.marqueeMode);
+  out.u8(current.layout);
+  out.u8(current.previewFps);
   
-  Serial.printf("Display settings saved (%d bytes)\n", bytesWritten);
+  uint8_t count = min(contents.size(), static_cast<size_t>(UINT8_MAX));
+  out.u8(count);
+  for (uint8_t i = 0; i < count; i++) {
+    const ScrollContent& content = contents[i];
+    out.u8(content.type);
+    out.u8(content.enabled);
+    out.u8(content.schedule.weight);
+    out.u8(content.schedule.advanceOnComplete);
+    out.u32(content.schedule.minDwellMs);
+    out.u32(content.schedule.maxDwellMs);
+    out.str(content.name);
+    out.str(content.content);
+  }
+}
+
+void saveDisplaySettings() {
+  markConfigDirty(CONFIG_DISPLAY);
 }
 
 void initializeDefaultScrollContents() {
   if (scrollContents.empty()) {
     scrollContents = DEFAULT_SCROLL_CONTENTS;
-    Serial.println("Loaded default scroll contents");
+    LOG_INFO(DISPLAY, "Loaded default scroll contents\n");
   }
 }
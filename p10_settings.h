@@ -7,7 +7,14 @@
 
 // Settings management functions
 void loadDisplaySettings();
-void saveDisplaySettings();
+void saveDisplaySettings();  // written by the config store shortly after
+class ConfigWriter;
+void encodeDisplayConfig(ConfigWriter& out);  // binary payload for the config store
+
+// Held by the config worker while it edits displaySettings or
+// scrollContents, and by the config store while it copies them
+void lockDisplaySettings();
+void unlockDisplaySettings();
 void initializeDefaultScrollContents();
 
 #endif
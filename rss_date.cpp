@@ -0,0 +1,244 @@
+#include "rss_date.h"
+#include <stdint.h>
+#include <string.h>
+
+namespace {
+
+struct DateCursor {
+  const char* p;
+  const char* end;
+};
+
+struct NamedZone {
+  const char* name;
+  int offsetMinutes;
+};
+
+// Zones seen in real feeds. IST is taken as India (the default feeds are
+// Indian outlets); single-letter military zones other than Z are treated
+// as UTC as RFC 2822 recommends.
+const NamedZone namedZones[] = {
+  {"GMT", 0}, {"UTC", 0}, {"UT", 0}, {"Z", 0},
+  {"EST", -300}, {"EDT", -240}, {"CST", -360}, {"CDT", -300},
+  {"MST", -420}, {"MDT", -360}, {"PST", -480}, {"PDT", -420},
+  {"IST", 330}, {"BST", 60}, {"CET", 60}, {"CEST", 120},
+  {"EET", 120}, {"EEST", 180}, {"MSK", 180}, {"GST", 240},
+  {"PKT", 300}, {"ICT", 420}, {"HKT", 480}, {"SGT", 480},
+  {"JST", 540}, {"KST", 540}, {"AEST", 600}, {"AEDT", 660},
+  {"NZST", 720}, {"NZDT", 780}
+};
+
+const char monthNames[] = "janfebmaraprmayjunjulaugsepoctnovdec";
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool isAlpha(char c) { return (c | 0x20) >= 'a' && (c | 0x20) <= 'z'; }
+inline char lower(char c) { return (c >= 'A' && c <= 'Z') ? c + 32 : c; }
+
+void skipSpaces(DateCursor& c) {
+  while (c.p < c.end && (*c.p == ' ' || *c.p == '\t' || *c.p == '\r' || *c.p == '\n')) {
+    c.p++;
+  }
+}
+
+// Reads between minDigits and maxDigits decimal digits
+bool readNumber(DateCursor& c, int minDigits, int maxDigits, int* value) {
+  int digits = 0;
+  int v = 0;
+  while (c.p < c.end && digits < maxDigits && isDigit(*c.p)) {
+    v = v * 10 + (*c.p - '0');
+    c.p++;
+    digits++;
+  }
+  if (digits < minDigits) return false;
+  *value = v;
+  return true;
+}
+
+bool expect(DateCursor& c, char ch) {
+  if (c.p < c.end && *c.p == ch) {
+    c.p++;
+    return true;
+  }
+  return false;
+}
+
+// Month name: accepts "Jun", "June", "JUNE"
+bool readMonth(DateCursor& c, int* month) {
+  if (c.end - c.p < 3) return false;
+  char a = lower(c.p[0]), b = lower(c.p[1]), d = lower(c.p[2]);
+  for (int i = 0; i < 12; i++) {
+    if (monthNames[i * 3] == a && monthNames[i * 3 + 1] == b && monthNames[i * 3 + 2] == d) {
+      *month = i + 1;
+      c.p += 3;
+      while (c.p < c.end && isAlpha(*c.p)) c.p++;
+      return true;
+    }
+  }
+  return false;
+}
+
+// "+0530", "-05:30", "+05", "Z", "GMT", "EST"; missing zone means UTC
+bool readZone(DateCursor& c, int* offsetMinutes) {
+  skipSpaces(c);
+  *offsetMinutes = 0;
+  if (c.p >= c.end) return true;
+
+  if (*c.p == '+' || *c.p == '-') {
+    int sign = (*c.p == '-') ? -1 : 1;
+    c.p++;
+    int hh = 0, mm = 0;
+    if (!readNumber(c, 2, 2, &hh)) return false;
+    expect(c, ':');
+    if (c.p < c.end && isDigit(*c.p)) {
+      if (!readNumber(c, 2, 2, &mm)) return false;
+    }
+    if (hh > 23 || mm > 59) return false;
+    *offsetMinutes = sign * (hh * 60 + mm);
+    return true;
+  }
+
+  const char* start = c.p;
+  while (c.p < c.end && isAlpha(*c.p)) c.p++;
+  size_t len = c.p - start;
+  if (len == 0) return true; // trailing junk we don't understand; treat as UTC
+
+  for (const auto& zone : namedZones) {
+    if (strlen(zone.name) != len) continue;
+    bool match = true;
+    for (size_t i = 0; i < len; i++) {
+      if ((start[i] & ~0x20) != zone.name[i]) {
+        match = false;
+        break;
+      }
+    }
+    if (match) {
+      *offsetMinutes = zone.offsetMinutes;
+      // "GMT+0530" style suffix
+      if (c.p < c.end && (*c.p == '+' || *c.p == '-')) {
+        int extra = 0;
+        if (readZone(c, &extra)) *offsetMinutes += extra;
+      }
+      return true;
+    }
+  }
+
+  // Unknown or military zone letter
+  return len == 1;
+}
+
+int daysInMonth(int year, int month) {
+  static const uint8_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  if (month == 2 && ((year % 4 == 0 && year % 100 != 0) || year % 400 == 0)) {
+    return 29;
+  }
+  return days[month - 1];
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant)
+long daysFromCivil(int y, int m, int d) {
+  y -= m <= 2;
+  const long era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<long>(doe) - 719468;
+}
+
+bool buildTime(int year, int month, int day, int hour, int minute, int second,
+               int offsetMinutes, time_t* out) {
+  if (month < 1 || month > 12) return false;
+  if (day < 1 || day > daysInMonth(year, month)) return false;
+  if (hour > 24 || minute > 59 || second > 60) return false;
+  if (hour == 24 && (minute || second)) return false;
+  if (second == 60) second = 59; // leap second
+
+  long days = daysFromCivil(year, month, day);
+  long long t = static_cast<long long>(days) * 86400LL + hour * 3600L + minute * 60L + second;
+  t -= offsetMinutes * 60L;
+  *out = static_cast<time_t>(t);
+  return true;
+}
+
+// HH:MM[:SS[.fff]]
+bool readClock(DateCursor& c, int* hour, int* minute, int* second) {
+  *second = 0;
+  if (!readNumber(c, 1, 2, hour)) return false;
+  if (!expect(c, ':')) return false;
+  if (!readNumber(c, 2, 2, minute)) return false;
+  if (expect(c, ':')) {
+    if (!readNumber(c, 2, 2, second)) return false;
+    if (c.p < c.end && (*c.p == '.' || *c.p == ',')) {
+      c.p++;
+      while (c.p < c.end && isDigit(*c.p)) c.p++;
+    }
+  }
+  return true;
+}
+
+// YYYY-MM-DD[(T| )HH:MM[:SS[.fff]]][zone]
+bool parseIso8601(DateCursor c, time_t* out) {
+  int year, month, day, hour = 0, minute = 0, second = 0, offset = 0;
+  if (!readNumber(c, 4, 4, &year)) return false;
+  if (!expect(c, '-')) return false;
+  if (!readNumber(c, 2, 2, &month)) return false;
+  if (!expect(c, '-')) return false;
+  if (!readNumber(c, 2, 2, &day)) return false;
+
+  if (c.p < c.end && (*c.p == 'T' || *c.p == 't' || *c.p == ' ')) {
+    c.p++;
+    if (!readClock(c, &hour, &minute, &second)) return false;
+    if (!readZone(c, &offset)) return false;
+  }
+  return buildTime(year, month, day, hour, minute, second, offset, out);
+}
+
+// [Day[name],] D[-| ]Mon[-| ]YY[YY] HH:MM[:SS] [zone]
+bool parseRfc822(DateCursor c, time_t* out) {
+  int year, month, day, hour, minute, second, offset;
+
+  // Optional day-of-week, abbreviated or in full
+  if (c.p < c.end && isAlpha(*c.p)) {
+    while (c.p < c.end && isAlpha(*c.p)) c.p++;
+    expect(c, ',');
+    skipSpaces(c);
+  }
+
+  if (!readNumber(c, 1, 2, &day)) return false;
+  if (!expect(c, '-')) skipSpaces(c);
+  if (!readMonth(c, &month)) return false;
+  if (!expect(c, '-')) skipSpaces(c);
+
+  const char* yearStart = c.p;
+  if (!readNumber(c, 2, 4, &year)) return false;
+  if (c.p - yearStart == 2) {
+    year += (year < 70) ? 2000 : 1900;
+  } else if (c.p - yearStart == 3) {
+    year += 1900;
+  }
+
+  skipSpaces(c);
+  if (!readClock(c, &hour, &minute, &second)) return false;
+  if (!readZone(c, &offset)) return false;
+  return buildTime(year, month, day, hour, minute, second, offset, out);
+}
+
+} // namespace
+
+bool parseFeedDate(const char* str, size_t len, time_t* out) {
+  if (!str || !out) return false;
+
+  DateCursor c = {str, str + len};
+  skipSpaces(c);
+  if (c.end - c.p < 8) return false;
+
+  // Four digits and a dash can only be ISO 8601
+  if (isDigit(c.p[0]) && isDigit(c.p[1]) && isDigit(c.p[2]) && isDigit(c.p[3]) && c.p[4] == '-') {
+    return parseIso8601(c, out);
+  }
+  return parseRfc822(c, out);
+}
+
+bool parseFeedDate(const char* str, time_t* out) {
+  if (!str) return false;
+  return parseFeedDate(str, strlen(str), out);
+}
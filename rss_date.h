@@ -0,0 +1,24 @@
+#ifndef RSS_DATE_H
+#define RSS_DATE_H
+
+#include <stddef.h>
+#include <time.h>
+
+// Publication date parsing for feed items.
+//
+// Understands the RFC 822 / RFC 1123 dates used by RSS ("Tue, 10 Jun 2003
+// 04:00:00 GMT", "10 Jun 03 04:00 +0530", RFC 850 "Tuesday, 10-Jun-03 ...")
+// and the RFC 3339 / ISO 8601 dates used by Atom ("2003-06-10T04:00:00Z",
+// "2003-06-10 04:00:00.123+05:30"). Numeric offsets and the common named
+// zones are applied, so the result is always UTC seconds since the epoch.
+//
+// The parser works on the raw bytes (no String, no strptime/mktime, no TZ
+// dependency) and never allocates.
+
+// Parse 'len' bytes at 'str' (need not be null terminated)
+bool parseFeedDate(const char* str, size_t len, time_t* out);
+
+// Parse a null terminated date string
+bool parseFeedDate(const char* str, time_t* out);
+
+#endif
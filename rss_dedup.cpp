@@ -0,0 +1,218 @@
+#include "rss_dedup.h"
+#include <string.h>
+
+namespace {
+
+struct Fingerprint {
+  uint64_t simHash;
+  uint32_t titleHash;  // 0 = empty slot
+  uint32_t linkHash;   // 0 = no link
+  uint32_t firstSeen;  // UTC seconds; 0 = not known yet
+  uint16_t cycle;      // cycle this story was last delivered in
+  uint16_t feedId;     // feed that delivered it in that cycle
+};
+
+Fingerprint fingerprints[DEDUP_CAPACITY];
+size_t nextSlot = 0;
+uint16_t currentCycle = 1;
+volatile bool resetPending = false;  // set by resetDedup(), applied by the fetcher
+uint16_t pendingRemovals[DEDUP_PENDING_REMOVALS];  // feed ids, 0 = free; atomics only
+
+const uint32_t FNV_OFFSET = 2166136261u;
+const uint32_t FNV_PRIME = 16777619u;
+const uint64_t ROLL_BASE = 1099511628211ull;
+
+inline char foldChar(char c) {
+  if (c >= 'A' && c <= 'Z') return c + 32;
+  if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) return c;
+  if (static_cast<uint8_t>(c) >= 0x80) return c; // keep UTF-8 bytes as-is
+  return ' ';
+}
+
+// splitmix64 finalizer: spreads rolling-hash bits before SimHash voting
+inline uint64_t mix64(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+inline int popcount64(uint64_t x) {
+  return __builtin_popcountll(x);
+}
+
+uint32_t hashLink(const char* link, size_t len) {
+  if (!link || len == 0) return 0;
+  const char* end = link + len;
+  // Scheme differences (http vs https) shouldn't make two links distinct
+  const char* p = link;
+  for (const char* s = link; s + 3 <= end && s - link < 8; s++) {
+    if (s[0] == ':' && s[1] == '/' && s[2] == '/') {
+      p = s + 3;
+      break;
+    }
+  }
+  uint32_t h = FNV_OFFSET;
+  for (; p < end; p++) {
+    h = (h ^ static_cast<uint8_t>(*p)) * FNV_PRIME;
+  }
+  return h ? h : 1;
+}
+
+// Normalize on the fly: fold case, collapse punctuation/whitespace runs
+// into one space, trim. Produces the exact hash and the SimHash in one pass.
+void fingerprintTitle(const char* title, size_t len, uint32_t* titleHash, uint64_t* simHash, int* shingles) {
+  int16_t votes[64] = {0};
+  uint64_t roll = 0;
+  uint64_t power = 1;  // ROLL_BASE^(DEDUP_SHINGLE-1), for removing the oldest char
+  for (int i = 1; i < DEDUP_SHINGLE; i++) power *= ROLL_BASE;
+
+  char window[DEDUP_SHINGLE];
+  size_t emitted = 0;
+  bool pendingSpace = false;
+  uint32_t h = FNV_OFFSET;
+  *shingles = 0;
+
+  for (size_t i = 0; i < len; i++) {
+    char c = foldChar(title[i]);
+    if (c == ' ') {
+      pendingSpace = emitted > 0;
+      continue;
+    }
+
+    // Emit the collapsed separator before the next real character
+    for (int pass = pendingSpace ? 0 : 1; pass < 2; pass++) {
+      char out = pass == 0 ? ' ' : c;
+      h = (h ^ static_cast<uint8_t>(out)) * FNV_PRIME;
+
+      if (emitted >= DEDUP_SHINGLE) {
+        roll -= power * static_cast<uint8_t>(window[emitted % DEDUP_SHINGLE]);
+      }
+      roll = roll * ROLL_BASE + static_cast<uint8_t>(out);
+      window[emitted % DEDUP_SHINGLE] = out;
+      emitted++;
+
+      if (emitted >= DEDUP_SHINGLE) {
+        uint64_t shingle = mix64(roll);
+        for (int bit = 0; bit < 64; bit++) {
+          votes[bit] += ((shingle >> bit) & 1) ? 1 : -1;
+        }
+        (*shingles)++;
+      }
+    }
+    pendingSpace = false;
+  }
+
+  uint64_t sim = 0;
+  for (int bit = 0; bit < 64; bit++) {
+    if (votes[bit] > 0) sim |= (1ull << bit);
+  }
+  *simHash = sim;
+  *titleHash = h ? h : 1;
+}
+
+// "Title - Reuters", "Title | BBC": drop a short trailing source suffix
+size_t stripSourceSuffix(const char* title, size_t len) {
+  const size_t maxSuffix = 24;
+  size_t limit = len > maxSuffix ? len - maxSuffix : 0;
+  if (limit < len / 2) limit = len / 2;
+  for (size_t i = len; i-- > limit + 1; ) {
+    if ((title[i] == '-' || title[i] == '|') && title[i - 1] == ' ' && i + 1 < len && title[i + 1] == ' ') {
+      return i - 1;
+    }
+  }
+  return len;
+}
+
+// The ring belongs to the fetcher task; other tasks only ask for a reset
+// or a feed's removal
+void applyPendingReset() {
+  for (size_t i = 0; i < DEDUP_PENDING_REMOVALS; i++) {
+    uint16_t feedId = __atomic_exchange_n(&pendingRemovals[i], 0, __ATOMIC_ACQUIRE);
+    if (!feedId) continue;
+    for (auto& fp : fingerprints) {
+      if (fp.feedId == feedId) fp.titleHash = 0;
+    }
+  }
+  
+  if (!resetPending) return;
+  resetPending = false;
+  memset(fingerprints, 0, sizeof(fingerprints));
+  nextSlot = 0;
+}
+
+} // namespace
+
+void beginDedupCycle() {
+  applyPendingReset();
+  currentCycle++;
+  if (currentCycle == 0) currentCycle = 1;
+}
+
+void resetDedup() {
+  resetPending = true;
+}
+
+void removeFeedFingerprints(uint16_t feedId) {
+  if (!feedId) return;
+  for (size_t i = 0; i < DEDUP_PENDING_REMOVALS; i++) {
+    uint16_t expected = 0;
+    if (__atomic_compare_exchange_n(&pendingRemovals[i], &expected, feedId, false,
+                                    __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+      return;
+    }
+  }
+  resetDedup();
+}
+
+DedupResult checkHeadline(const char* title, size_t titleLen,
+                          const char* link, size_t linkLen, uint16_t feedId,
+                          uint32_t* seenAt) {
+  applyPendingReset();
+  
+  uint32_t titleHash;
+  uint64_t simHash;
+  int shingles;
+  fingerprintTitle(title, stripSourceSuffix(title, titleLen), &titleHash, &simHash, &shingles);
+  uint32_t linkHash = hashLink(link, linkLen);
+  uint32_t now = seenAt ? *seenAt : 0;
+
+  // Very short titles make SimHash meaningless; only match them exactly
+  bool allowNear = shingles >= 8;
+
+  for (size_t i = 0; i < DEDUP_CAPACITY; i++) {
+    Fingerprint& fp = fingerprints[i];
+    if (fp.titleHash == 0) continue;
+
+    bool match = fp.titleHash == titleHash ||
+                 (linkHash && fp.linkHash == linkHash) ||
+                 (allowNear && popcount64(fp.simHash ^ simHash) <= DEDUP_NEAR_DISTANCE);
+    if (!match) continue;
+
+    // A feed re-delivering its own story this cycle (a re-fetch) is not
+    // a duplicate; another feed delivering it is
+    if (fp.cycle == currentCycle && fp.feedId != feedId) {
+      return DEDUP_DUPLICATE;
+    }
+
+    bool seenBefore = fp.cycle != currentCycle;
+    fp.cycle = currentCycle;
+    fp.feedId = feedId;
+    if (!fp.linkHash) fp.linkHash = linkHash;
+    if (!fp.firstSeen) fp.firstSeen = now;
+    if (seenAt) *seenAt = fp.firstSeen;
+    return seenBefore ? DEDUP_SEEN : DEDUP_NEW;
+  }
+
+  Fingerprint& slot = fingerprints[nextSlot];
+  nextSlot = (nextSlot + 1) % DEDUP_CAPACITY;
+  slot.simHash = simHash;
+  slot.titleHash = titleHash;
+  slot.linkHash = linkHash;
+  slot.firstSeen = now;
+  slot.cycle = currentCycle;
+  slot.feedId = feedId;
+  return DEDUP_NEW;
+}
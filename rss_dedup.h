@@ -0,0 +1,50 @@
+#ifndef RSS_DEDUP_H
+#define RSS_DEDUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Headline fingerprinting across feeds and fetch cycles.
+//
+// Each ingested item leaves a fingerprint: a hash of its normalized title
+// (lowercase alphanumerics, punctuation collapsed), a 64-bit SimHash built
+// from rolling hashes of the title's character shingles, and a hash of its
+// GUID or link. Titles whose SimHash differs in only a few bits are treated
+// as the same story ("Quake hits Japan's coast" vs "Quake hits Japan coast"),
+// and a short trailing source suffix (" - Reuters", " | BBC") is ignored.
+//
+// Fingerprints live in a fixed ring, so memory is bounded regardless of how
+// many feeds or cycles pass through.
+
+#define DEDUP_CAPACITY 256
+#define DEDUP_NEAR_DISTANCE 10  // max differing SimHash bits for a near-duplicate
+#define DEDUP_SHINGLE 5        // characters per rolling-hash shingle
+#define DEDUP_PENDING_REMOVALS 4  // feed removals queued for the fetcher
+
+enum DedupResult {
+  DEDUP_NEW = 0,        // never seen before: first appearance this cycle
+  DEDUP_SEEN = 1,       // seen in an earlier cycle, still worth showing
+  DEDUP_DUPLICATE = 2   // another feed already delivered it this cycle
+};
+
+// Start a new fetch cycle; items not seen before it count as new
+void beginDedupCycle();
+
+// Classify an item and record its fingerprint. 'link' may be null.
+// 'seenAt', if given, holds the current time in UTC seconds (0 while the
+// clock is unset) and comes back as the time the story was first seen,
+// 0 if that is unknown; undated items are ordered by it.
+DedupResult checkHeadline(const char* title, size_t titleLen,
+                          const char* link, size_t linkLen, uint16_t feedId,
+                          uint32_t* seenAt = nullptr);
+
+// Forget everything (e.g. after the feed list changes). Safe from any
+// task: the fetcher clears the ring before it next checks a headline.
+void resetDedup();
+
+// Forget the fingerprints a feed delivered last (e.g. after it is
+// deleted), keeping the other feeds'. Safe from any task, like
+// resetDedup(), which it falls back to if too many are queued.
+void removeFeedFingerprints(uint16_t feedId);
+
+#endif
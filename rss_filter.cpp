@@ -0,0 +1,52 @@
+#include "rss_filter.h"
+#include "log.h"
+
+namespace {
+
+KeywordAutomaton* activeFilter = nullptr;
+SemaphoreHandle_t filterMutex = nullptr;
+size_t filterRules = 0;     // of activeFilter, updated with it
+size_t filterStates = 0;
+
+} // namespace
+
+void compileKeywordFilter() {
+  unsigned long start = millis();
+  if (!filterMutex) {
+    filterMutex = xSemaphoreCreateMutex();
+  }
+
+  KeywordAutomaton* compiled = compileKeywords(settings.blockKeywords.c_str(),
+                                               settings.boostKeywords.c_str());
+
+  xSemaphoreTake(filterMutex, portMAX_DELAY);
+  KeywordAutomaton* old = activeFilter;
+  activeFilter = compiled;
+  // Counts are kept apart so readers never touch an automaton that a
+  // later compile may delete
+  filterRules = keywordRules(compiled);
+  filterStates = keywordStates(compiled);
+  xSemaphoreGive(filterMutex);
+  freeKeywords(old);
+
+  LOG_INFO(RSS, "Keyword filter compiled: %u rules, %u states in %lu ms\n",
+                filterRules, filterStates, millis() - start);
+}
+
+uint8_t matchKeywordFilter(const char* text, size_t len) {
+  if (!filterMutex || !text) return FILTER_NONE;
+
+  // Checked under the lock: a compile with no keywords clears it
+  xSemaphoreTake(filterMutex, portMAX_DELAY);
+  uint8_t flags = matchKeywords(activeFilter, text, len);
+  xSemaphoreGive(filterMutex);
+  return flags;
+}
+
+size_t keywordFilterRules() {
+  return filterRules;
+}
+
+size_t keywordFilterStates() {
+  return filterStates;
+}
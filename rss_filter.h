@@ -0,0 +1,24 @@
+#ifndef RSS_FILTER_H
+#define RSS_FILTER_H
+
+#include "config.h"
+#include "rss_keywords.h"
+
+// Keyword allow/block filtering for headlines.
+//
+// settings.blockKeywords and settings.boostKeywords are compiled into a
+// single Aho-Corasick automaton (see rss_keywords.h) whenever the
+// configuration changes, so a title is checked against every rule in one
+// pass over its characters.
+
+// Rebuild the automaton from the current settings
+void compileKeywordFilter();
+
+// Returns a mask of FilterMatch flags for the given title
+uint8_t matchKeywordFilter(const char* text, size_t len);
+
+// Size of the compiled automaton, for diagnostics
+size_t keywordFilterRules();
+size_t keywordFilterStates();
+
+#endif
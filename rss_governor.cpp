@@ -0,0 +1,123 @@
+#include "rss_governor.h"
+#include "config.h"
+#include "rss_handler.h"
+
+MemoryMetrics memoryMetrics = {
+  {UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX},
+  {UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX},
+  {0, 0, 0, 0}
+};
+
+static const char* const strategyNames[STRATEGY_COUNT] = {"full", "reduced", "stream", "defer"};
+static const char* const stageNames[STAGE_COUNT] = {
+  "beforeFetch", "connected", "downloaded", "parsed", "cleanedUp"
+};
+
+MemorySnapshot takeMemorySnapshot() {
+  MemorySnapshot mem;
+  mem.freeHeap = ESP.getFreeHeap();
+  mem.largestBlock = ESP.getMaxAllocHeap();
+  mem.freePsram = psramFound() ? ESP.getFreePsram() : 0;
+  mem.largestPsram = psramFound() ? ESP.getMaxAllocPsram() : 0;
+  return mem;
+}
+
+FetchStrategy checkFetchHeadroom(bool secure) {
+  MemorySnapshot mem = takeMemorySnapshot();
+  uint32_t reserve = secure ? GOVERNOR_TLS_RESERVE : GOVERNOR_HTTP_RESERVE;
+
+  // The connection itself always lives in internal RAM
+  if (mem.freeHeap < reserve + GOVERNOR_MARGIN / 2) {
+    return STRATEGY_DEFER;
+  }
+  return STRATEGY_FULL;
+}
+
+// Free space in one memory region
+struct RegionRoom {
+  uint32_t largest;
+  uint32_t free;
+};
+
+static uint32_t aboveMargin(uint32_t bytes) {
+  return bytes > GOVERNOR_MARGIN ? bytes - GOVERNOR_MARGIN : 0;
+}
+
+// Largest payload up to 'wanted' that fits with its buffer in 'home'. The
+// buffer needs one block there. Parse nodes (roughly 3/4 of the payload,
+// less what the arena already holds) take what is left in 'home' and
+// then 'other', since bulk allocations spill from one region to the next.
+static size_t fitPayload(const RegionRoom& home, const RegionRoom& other,
+                         size_t wanted, size_t arenaBytes) {
+  size_t byBlock = aboveMargin(home.largest);
+  size_t byHome = aboveMargin(home.free);
+  // payload + (payload * 3/4 - arena) <= both regions' room
+  size_t byTotal = (static_cast<size_t>(byHome) + aboveMargin(other.free) + arenaBytes) * 4 / 7;
+  return min(min(wanted, byBlock), min(byHome, byTotal));
+}
+
+FetchPlan planFeedPayload(int contentLength, size_t arenaBytes) {
+  MemorySnapshot mem = takeMemorySnapshot();
+  FetchPlan plan = {STRATEGY_FULL, MAX_FEED_PAYLOAD, settings.maxHeadlinesPerFeed};
+
+  size_t payload = MAX_FEED_PAYLOAD;
+  if (contentLength > 0 && static_cast<size_t>(contentLength) < payload) {
+    payload = contentLength;
+  }
+
+  // Each region is checked on its own: the payload buffer lands in PSRAM
+  // when a block there takes it, otherwise in internal RAM
+  RegionRoom internal = {mem.largestBlock, mem.freeHeap};
+  RegionRoom psram = {mem.largestPsram, mem.freePsram};
+  size_t fit = fitPayload(internal, psram, payload, arenaBytes);
+  if (mem.largestPsram > 0) {
+    fit = max(fit, fitPayload(psram, internal, payload, arenaBytes));
+  }
+
+  if (fit >= payload) {
+    plan.payloadLimit = payload;
+    return plan;
+  }
+
+  // Shrink the download to what fits, and the item count with it
+  if (fit >= GOVERNOR_MIN_REDUCED) {
+    plan.strategy = STRATEGY_REDUCED;
+    plan.payloadLimit = fit;
+    plan.maxItems = max(3, static_cast<int>(settings.maxHeadlinesPerFeed * fit / payload));
+    return plan;
+  }
+
+  // The window is static, so streaming only needs room for the connection
+  if (mem.freeHeap >= GOVERNOR_MARGIN / 2) {
+    plan.strategy = STRATEGY_STREAM;
+    plan.payloadLimit = 0;
+    return plan;
+  }
+
+  plan.strategy = STRATEGY_DEFER;
+  plan.payloadLimit = 0;
+  return plan;
+}
+
+void recordFetchStrategy(FetchStrategy strategy) {
+  memoryMetrics.strategyCount[strategy]++;
+}
+
+void noteMemoryStage(FetchStage stage, const char* feedName) {
+  uint32_t freeHeap = ESP.getFreeHeap();
+  uint32_t largest = ESP.getMaxAllocHeap();
+
+  if (freeHeap < memoryMetrics.stageMinFree[stage]) memoryMetrics.stageMinFree[stage] = freeHeap;
+  if (largest < memoryMetrics.stageMinBlock[stage]) memoryMetrics.stageMinBlock[stage] = largest;
+
+  Serial.printf("[%s %s] Free heap: %u bytes, largest block: %u\n",
+                feedName, stageNames[stage], freeHeap, largest);
+}
+
+const char* fetchStrategyName(FetchStrategy strategy) {
+  return strategy < STRATEGY_COUNT ? strategyNames[strategy] : "?";
+}
+
+const char* fetchStageName(FetchStage stage) {
+  return stage < STAGE_COUNT ? stageNames[stage] : "?";
+}
@@ -0,0 +1,79 @@
+#ifndef RSS_GOVERNOR_H
+#define RSS_GOVERNOR_H
+
+#include <Arduino.h>
+
+// Memory governor for the feed fetch pipeline.
+//
+// Before a feed is fetched, and again once its size is known, the governor
+// looks at free heap and the largest free block (internal and PSRAM) and
+// picks how to process it:
+//   full     - download up to MAX_FEED_PAYLOAD and parse it as a document
+//   reduced  - download only what fits and keep fewer items
+//   stream   - never hold the payload; scan it through a small window
+//   defer    - not enough memory to even connect; retry later
+//
+// It also keeps heap low-water marks for each pipeline stage.
+
+#define GOVERNOR_TLS_RESERVE 40000   // internal heap an HTTPS handshake needs
+#define GOVERNOR_HTTP_RESERVE 12000  // same for plain HTTP
+#define GOVERNOR_MARGIN 16000        // left free for the rest of the system
+#define GOVERNOR_MIN_REDUCED 12000   // smallest payload worth a full parse
+#define STREAM_WINDOW 4096           // scan window for the streaming strategy
+
+enum FetchStrategy : uint8_t {
+  STRATEGY_FULL = 0,
+  STRATEGY_REDUCED,
+  STRATEGY_STREAM,
+  STRATEGY_DEFER,
+  STRATEGY_COUNT
+};
+
+enum FetchStage : uint8_t {
+  STAGE_BEFORE_FETCH = 0,
+  STAGE_CONNECTED,    // headers received, TLS session alive
+  STAGE_DOWNLOADED,
+  STAGE_PARSED,
+  STAGE_CLEANED_UP,
+  STAGE_COUNT
+};
+
+struct MemorySnapshot {
+  uint32_t freeHeap;      // internal
+  uint32_t largestBlock;  // internal
+  uint32_t freePsram;
+  uint32_t largestPsram;
+};
+
+struct FetchPlan {
+  FetchStrategy strategy;
+  size_t payloadLimit;  // bytes to download for full/reduced
+  int maxItems;
+};
+
+struct MemoryMetrics {
+  uint32_t stageMinFree[STAGE_COUNT];
+  uint32_t stageMinBlock[STAGE_COUNT];
+  uint32_t strategyCount[STRATEGY_COUNT];
+};
+
+extern MemoryMetrics memoryMetrics;
+
+MemorySnapshot takeMemorySnapshot();
+
+// Before connecting: STRATEGY_DEFER if a connection would not fit
+FetchStrategy checkFetchHeadroom(bool secure);
+
+// Once headers are in. contentLength is -1 when unknown (chunked);
+// arenaBytes is parse memory the XML arena already holds.
+FetchPlan planFeedPayload(int contentLength, size_t arenaBytes);
+
+void recordFetchStrategy(FetchStrategy strategy);
+
+// Records (and logs) heap at a pipeline stage
+void noteMemoryStage(FetchStage stage, const char* feedName);
+
+const char* fetchStrategyName(FetchStrategy strategy);
+const char* fetchStageName(FetchStage stage);
+
+#endif
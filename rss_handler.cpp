@@ -1,34 +1,396 @@
 
 #include "rss_handler.h"
+#include "rss_date.h"
+#include "rss_dedup.h"
+#include "rss_filter.h"
+#include "rss_governor.h"
+#include "rss_scan.h"
 #include "p10_display.h"
+#include "mem_policy.h"
+#include "log.h"
+
+// Any clock earlier than this has not been set by NTP/RTC yet
+#define MIN_VALID_EPOCH 1577836800 // 2020-01-01
+
+FetchStatus fetchStatus;
+
+static QueueHandle_t fetchQueue = nullptr;
+static portMUX_TYPE fetchStatusMux = portMUX_INITIALIZER_UNLOCKED;
+static bool fetchQueued = false;  // a full cycle is waiting in fetchQueue
+
+// Queue entries: a feed id, or this for a full cycle
+#define FETCH_ALL_FEEDS 0
+#define FETCH_QUEUE_LENGTH 8
+
+// One parse context reused for every feed. Clearing it between documents
+// returns nodes to its pools without giving the blocks back to the heap.
+static tinyxml2::XMLDocument feedDoc;
+
+// The only elements handleFeedFetch() reads; everything else in a feed
+// (descriptions, media groups, categories) is skipped without building nodes
+static const char* const feedPaths[] = {
+  "rss/channel/item/title", "rss/channel/item/pubDate", "rss/channel/item/date",
+  "rss/channel/item/guid", "rss/channel/item/link",
+  "feed/entry/title", "feed/entry/published", "feed/entry/updated",
+  "feed/entry/id", "feed/entry/link"
+};
+
+// Owns a downloaded payload, with room for the NUL the parser needs
+struct PayloadBuffer {
+  char* data;
+  size_t length = 0;
+  
+  explicit PayloadBuffer(size_t capacity) : data(static_cast<char*>(memAlloc(capacity + 1, ALLOC_BULK))) {}
+  ~PayloadBuffer() { memFree(data); }
+};
+
+static void setupXmlArena() {
+  // Parse memory is bulk: it goes to PSRAM when the board has it. When
+  // neither region has room the parse fails with XML_ERROR_OUT_OF_MEMORY
+  // and the feed goes through the allocation-free fallback scan.
+  tinyxml2::SetBlockAllocator(bulkAlloc, memFree);
+  feedDoc.SetRetainMemory(true);
+  feedDoc.SetPathFilter(feedPaths, sizeof(feedPaths) / sizeof(feedPaths[0]));
+  if (psramFound()) {
+    // Feeds parse in place in the payload, so no character buffer is needed
+    if (!feedDoc.Reserve(0, XML_ARENA_ELEMENTS, XML_ARENA_ATTRIBUTES, XML_ARENA_TEXTS)) {
+      LOG_WARN(RSS, "XML arena: reserve failed, pools will grow per parse\n");
+    }
+  }
+  LOG_INFO(RSS, "XML arena: %u bytes reserved%s\n", feedDoc.ArenaBytes(), psramFound() ? " in PSRAM" : "");
+}
+
+// Fetches one feed on its own, e.g. right after it was added or edited
+static void fetchSingleFeed(uint16_t id) {
+  lockFeeds();
+  int index = findFeedIndex(id);
+  RSSFeed feed;
+  if (index >= 0) feed = feeds[index];
+  unlockFeeds();
+  
+  if (index < 0 || !feed.enabled) return;
+  if (!hasInternet) {
+    LOG_WARN(RSS, "No internet connection - skipping feed fetch\n");
+    return;
+  }
+  
+  FeedFetchResult result = handleFeedFetch(feed);
+  LOG_INFO(RSS, "Single feed fetch %s: %s\n", feed.name.c_str(),
+                result == FEED_OK ? "ok" : result == FEED_DEFERRED ? "deferred" : "failed");
+  if (!psramFound()) {
+    feedDoc.ReleaseMemory();
+  }
+}
+
+// Fetcher task: the only place that touches the network for feeds
+static void rssFetcherTask(void* parameter) {
+  uint16_t request;
+  
+  for (;;) {
+    xQueueReceive(fetchQueue, &request, portMAX_DELAY);
+    
+    if (request != FETCH_ALL_FEEDS) {
+      fetchSingleFeed(request);
+      continue;
+    }
+    
+    portENTER_CRITICAL(&fetchStatusMux);
+    fetchQueued = false;
+    fetchStatus.inProgress = true;
+    portEXIT_CRITICAL(&fetchStatusMux);
+    
+    LOG_INFO(RSS, "--- Starting RSS Feed Fetch Cycle ---\n");
+    fetchAllRSSFeeds();
+    LOG_INFO(RSS, "--- RSS Feed Fetch Cycle Complete ---\n");
+    
+    portENTER_CRITICAL(&fetchStatusMux);
+    fetchStatus.inProgress = false;
+    portEXIT_CRITICAL(&fetchStatusMux);
+  }
+}
+
+void startRSSFetcher() {
+  if (fetchQueue) return;
+  
+  setupXmlArena();
+  fetchQueue = xQueueCreate(FETCH_QUEUE_LENGTH, sizeof(uint16_t));
+  xTaskCreate(rssFetcherTask, "RSS_Fetcher", 12288, NULL, 1, NULL);
+  LOG_INFO(RSS, "RSS fetcher task started\n");
+}
+
+bool requestRSSFetch() {
+  if (!fetchQueue) return false;
+  
+  // Single flight: a request while a cycle runs, or while one is already
+  // queued, is folded into that cycle
+  portENTER_CRITICAL(&fetchStatusMux);
+  bool collapse = fetchStatus.inProgress || fetchQueued;
+  if (collapse) {
+    fetchStatus.collapsedRequests++;
+  } else {
+    fetchQueued = true;
+  }
+  portEXIT_CRITICAL(&fetchStatusMux);
+  
+  if (collapse) {
+    return false;
+  }
+  
+  uint16_t request = FETCH_ALL_FEEDS;
+  if (xQueueSend(fetchQueue, &request, 0) != pdTRUE) {
+    portENTER_CRITICAL(&fetchStatusMux);
+    fetchQueued = false;
+    portEXIT_CRITICAL(&fetchStatusMux);
+    return false;
+  }
+  return true;
+}
+
+bool requestFeedFetch(uint16_t id) {
+  if (!fetchQueue || id == FETCH_ALL_FEEDS) return false;
+  
+  // A full cycle that hasn't started yet will fetch it anyway
+  portENTER_CRITICAL(&fetchStatusMux);
+  bool covered = fetchQueued;
+  portEXIT_CRITICAL(&fetchStatusMux);
+  if (covered) return true;
+  
+  return xQueueSend(fetchQueue, &id, 0) == pdTRUE;
+}
+
+static void recordFeedResult(FeedFetchResult result) {
+  portENTER_CRITICAL(&fetchStatusMux);
+  fetchStatus.feedsDone++;
+  if (result == FEED_OK) {
+    fetchStatus.succeeded++;
+  } else if (result == FEED_DEFERRED) {
+    fetchStatus.deferred++;
+  } else {
+    fetchStatus.failed++;
+  }
+  portEXIT_CRITICAL(&fetchStatusMux);
+}
+
+// A feed deleted or switched off after the cycle took its snapshot is
+// not fetched, and whatever it delivered meanwhile is dropped
+static bool feedStillWanted(uint16_t id) {
+  lockFeeds();
+  int index = findFeedIndex(id);
+  bool wanted = index >= 0 && feeds[index].enabled;
+  unlockFeeds();
+  return wanted;
+}
+
+static void dropIfUnwanted(uint16_t id) {
+  if (!feedStillWanted(id)) {
+    clearFeedHeadlines(id);
+    rebuildHeadlineOrder();
+  }
+}
 
 void fetchAllRSSFeeds() {
   if (!hasInternet) {
-    Serial.println("No internet connection - skipping RSS fetch");
+    LOG_WARN(RSS, "No internet connection - skipping RSS fetch\n");
     return;
   }
   
   logMemoryUsage("Before RSS fetch");
-  Serial.println("Starting RSS feed fetch cycle...");
-  
-  clearRSSHeadlines(); // Clear old headlines
+  LOG_INFO(RSS, "Starting RSS feed fetch cycle...\n");
+  unsigned long cycleStart = millis();
   
-  int successCount = 0;
-  for (const auto& feed : feeds) {
-    if (feed.enabled) {
-      handleFeedFetch(feed);
-      successCount++;
+  // A bulk replace or reset of the list mid-cycle starts the cycle over
+  // with the new list; single-feed edits are checked feed by feed
+  uint32_t listVersion;
+  do {
+    beginDedupCycle();
+    
+    // Work from a snapshot so web edits to 'feeds' can't move it under us
+    lockFeeds();
+    std::vector<RSSFeed> cycleFeeds = feeds;
+    listVersion = feedListVersion;
+    unlockFeeds();
+    
+    // Each feed replaces its own headlines as it is fetched, so only drop
+    // the ones belonging to feeds that are no longer enabled
+    uint16_t enabledCount = 0;
+    for (uint16_t i = 0; i < cycleFeeds.size(); i++) {
+      if (!cycleFeeds[i].enabled) {
+        clearFeedHeadlines(cycleFeeds[i].id);
+      } else {
+        enabledCount++;
+      }
+    }
+    
+    portENTER_CRITICAL(&fetchStatusMux);
+    fetchStatus.feedsDone = 0;
+    fetchStatus.feedsTotal = enabledCount;
+    fetchStatus.succeeded = 0;
+    fetchStatus.failed = 0;
+    fetchStatus.deferred = 0;
+    portEXIT_CRITICAL(&fetchStatusMux);
+    
+    std::vector<uint16_t> deferredFeeds;
+    for (uint16_t i = 0; i < cycleFeeds.size() && feedListVersion == listVersion; i++) {
+      if (!cycleFeeds[i].enabled || !feedStillWanted(cycleFeeds[i].id)) continue;
+      
+      FeedFetchResult result = handleFeedFetch(cycleFeeds[i]);
+      dropIfUnwanted(cycleFeeds[i].id);
+      if (result == FEED_DEFERRED) {
+        deferredFeeds.push_back(i);
+      } else {
+        recordFeedResult(result);
+      }
+      
       delay(500);
     }
-  }
+    
+    // Retry deferred feeds once the others are done and their memory is back
+    if (!deferredFeeds.empty() && feedListVersion == listVersion) {
+      if (!psramFound()) {
+        feedDoc.ReleaseMemory();
+      }
+      delay(2000);
+      for (uint16_t i : deferredFeeds) {
+        if (feedListVersion != listVersion || !feedStillWanted(cycleFeeds[i].id)) continue;
+        LOG_INFO(RSS, "Retrying deferred feed: %s\n", cycleFeeds[i].name.c_str());
+        recordFeedResult(handleFeedFetch(cycleFeeds[i]));
+        dropIfUnwanted(cycleFeeds[i].id);
+        delay(500);
+      }
+    }
+    
+    if (feedListVersion != listVersion) {
+      LOG_INFO(RSS, "Feed list replaced during the fetch - starting the cycle over\n");
+    }
+  } while (feedListVersion != listVersion);
+  
+  size_t headlineCount = allRSSHeadlines.size();
+  portENTER_CRITICAL(&fetchStatusMux);
+  fetchStatus.cycles++;
+  fetchStatus.lastCycleEnd = millis();
+  fetchStatus.lastCycleMs = fetchStatus.lastCycleEnd - cycleStart;
+  fetchStatus.lastHeadlines = headlineCount;
+  portEXIT_CRITICAL(&fetchStatusMux);
+  
+  LOG_INFO(RSS, "RSS fetch complete: %d ok, %d failed, %d deferred in %lu ms\n",
+                fetchStatus.succeeded, fetchStatus.failed, fetchStatus.deferred, fetchStatus.lastCycleMs);
   
-  Serial.printf("RSS fetch complete: %d feeds processed\n", successCount);
+  // Without PSRAM the arena is internal heap; only hold it during a cycle
+  fetchStatus.xmlArenaBytes = feedDoc.ArenaBytes();
+  if (!psramFound()) {
+    feedDoc.ReleaseMemory();
+  }
   logMemoryUsage("After RSS fetch");
 }
 
-void handleFeedFetch(const RSSFeed& feed) {
-  Serial.printf("Fetching: %s\n", feed.name.c_str());
-  logMemoryUsage("Before feed fetch");
+// Collects the response body into a fixed buffer and stops the download
+// once it is full
+class PayloadSink : public Stream {
+public:
+  PayloadSink(char* buffer, size_t capacity) : buffer(buffer), capacity(capacity) {}
+  
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* data, size_t len) override {
+    if (len > capacity - used) {
+      full = true;
+      len = capacity - used;
+    }
+    memcpy(buffer + used, data, len);
+    used += len;
+    return len;  // a short write makes HTTPClient stop reading
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  
+  size_t length() const { return used; }
+  bool truncated() const { return full; }
+
+private:
+  char* buffer;
+  size_t capacity;
+  size_t used = 0;
+  bool full = false;
+};
+
+// Streaming strategy: runs the item scanner over a small window as the
+// body arrives, so the payload is never held in memory
+class FeedStreamScanner : public Stream {
+public:
+  explicit FeedStreamScanner(IngestContext* ingest) : ingest(ingest) {}
+  
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* data, size_t len) override {
+    size_t consumed = 0;
+    while (consumed < len && !done) {
+      size_t n = min(len - consumed, sizeof(window) - used);
+      memcpy(window + used, data + consumed, n);
+      used += n;
+      consumed += n;
+      total += n;
+      if (used == sizeof(window)) scanWindow(false);
+    }
+    return consumed;
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  
+  void finish() {
+    if (!done) scanWindow(true);
+  }
+  size_t bytes() const { return total; }
+
+private:
+  // Shared by all fetches; static so streaming works even when the heap
+  // is too fragmented to allocate it
+  static char window[STREAM_WINDOW];
+  IngestContext* ingest;
+  size_t used = 0;
+  size_t total = 0;
+  bool done = false;
+  
+  // Start of the last <item>/<entry> in the window, which may be incomplete
+  size_t lastItemStart() const {
+    for (size_t i = used; i-- > 0; ) {
+      if (window[i] != '<') continue;
+      const char* tag = window + i + 1;
+      size_t left = used - i - 1;
+      size_t nameLen = (left >= 5 && memcmp(tag, "entry", 5) == 0) ? 5 :
+                       (left >= 4 && memcmp(tag, "item", 4) == 0) ? 4 : 0;
+      if (nameLen && left > nameLen && (tag[nameLen] == '>' || tag[nameLen] == ' ')) {
+        return i;
+      }
+    }
+    return 0;
+  }
+  
+  void scanWindow(bool last) {
+    // Scan complete items; carry the unfinished one over. An item bigger
+    // than the window is scanned as far as it got.
+    size_t cut = last ? used : lastItemStart();
+    if (cut == 0) cut = used;
+    
+    scanFeedItems(window, cut, ingestFeedItem, ingest);
+    if (ingest->added >= ingest->limit) done = true;
+    
+    memmove(window, window + cut, used - cut);
+    used -= cut;
+  }
+};
+
+char FeedStreamScanner::window[STREAM_WINDOW];
+
+FeedFetchResult handleFeedFetch(const RSSFeed& feed) {
+  LOG_INFO(RSS, "Fetching: %s\n", feed.name.c_str());
+  noteMemoryStage(STAGE_BEFORE_FETCH, feed.name.c_str());
+  
+  // Don't open a connection the heap can't carry
+  if (checkFetchHeadroom(feed.url.startsWith("https")) == STRATEGY_DEFER) {
+    LOG_WARN(RSS, "%s - Low memory (%u bytes free), deferring\n", feed.name.c_str(), ESP.getFreeHeap());
+    recordFetchStrategy(STRATEGY_DEFER);
+    return FEED_DEFERRED;
+  }
 
   HTTPClient http;
   http.setTimeout(HTTP_TIMEOUT);
@@ -38,8 +400,8 @@ void handleFeedFetch(const RSSFeed& feed) {
   http.setReuse(false);
 
   if (!http.begin(feed.url)) {
-    Serial.printf("%s - HTTP begin failed\n", feed.name.c_str());
-    return;
+    LOG_ERROR(RSS, "%s - HTTP begin failed\n", feed.name.c_str());
+    return FEED_FAILED;
   }
 
   int httpCode = http.GET();
@@ -48,7 +410,7 @@ void handleFeedFetch(const RSSFeed& feed) {
     String newUrl = http.getLocation();
     http.end();
     if (newUrl.length() > 0) {
-      Serial.printf("%s - Redirected to: %s\n", feed.name.c_str(), newUrl.c_str());
+      LOG_INFO(RSS, "%s - Redirected to: %s\n", feed.name.c_str(), newUrl.c_str());
       if (http.begin(newUrl)) {
         httpCode = http.GET();
       }
@@ -56,140 +418,293 @@ void handleFeedFetch(const RSSFeed& feed) {
   }
 
   if (httpCode <= 0) {
-    Serial.printf("%s - HTTP error: %d\n", feed.name.c_str(), httpCode);
+    LOG_ERROR(RSS, "%s - HTTP error: %d\n", feed.name.c_str(), httpCode);
     http.end();
-    return;
+    return FEED_FAILED;
   }
 
   if (httpCode != HTTP_CODE_OK) {
-    Serial.printf("%s - HTTP status: %d\n", feed.name.c_str(), httpCode);
+    LOG_WARN(RSS, "%s - HTTP status: %d\n", feed.name.c_str(), httpCode);
     http.end();
-    return;
+    return FEED_FAILED;
   }
 
-  String payload = http.getString();
+  noteMemoryStage(STAGE_CONNECTED, feed.name.c_str());
+  
+  // Now that the size is known, pick how to process the body
+  FetchPlan plan = planFeedPayload(http.getSize(), feedDoc.ArenaBytes());
+  recordFetchStrategy(plan.strategy);
+  if (plan.strategy != STRATEGY_FULL) {
+    LOG_INFO(RSS, "%s - Memory governor: %s strategy (limit %u bytes, %d items)\n",
+                  feed.name.c_str(), fetchStrategyName(plan.strategy), plan.payloadLimit, plan.maxItems);
+  }
+  
+  if (plan.strategy == STRATEGY_DEFER) {
+    http.end();
+    return FEED_DEFERRED;
+  }
+  
+  IngestContext ingest(feed);
+  ingest.limit = plan.maxItems;
+  
+  if (plan.strategy == STRATEGY_STREAM) {
+    clearFeedHeadlines(feed.id);
+    FeedStreamScanner scanner(&ingest);
+    http.writeToStream(&scanner);
+    scanner.finish();
+    http.end();
+    
+    LOG_INFO(RSS, "%s - Streamed %u bytes\n", feed.name.c_str(), scanner.bytes());
+    noteMemoryStage(STAGE_PARSED, feed.name.c_str());
+    logIngestResults(ingest);
+    rebuildHeadlineOrder();
+    return scanner.bytes() >= 50 ? FEED_OK : FEED_FAILED;
+  }
+  
+  // One allocation sized by the plan; PSRAM when the board has it
+  PayloadBuffer payload(plan.payloadLimit);
+  if (!payload.data) {
+    LOG_WARN(RSS, "%s - Could not allocate %u bytes, deferring\n", feed.name.c_str(), plan.payloadLimit);
+    http.end();
+    return FEED_DEFERRED;
+  }
+  
+  PayloadSink sink(payload.data, plan.payloadLimit);
+  http.writeToStream(&sink);
   http.end();
+  payload.length = sink.length();
+  payload.data[payload.length] = '\0';
   
-  Serial.printf("%s - Downloaded %d bytes\n", feed.name.c_str(), payload.length());
-  logMemoryUsage("After download");
+  LOG_INFO(RSS, "%s - Downloaded %u bytes%s\n", feed.name.c_str(), payload.length,
+                sink.truncated() ? " (truncated)" : "");
+  noteMemoryStage(STAGE_DOWNLOADED, feed.name.c_str());
 
-  if (payload.length() < 50) {
-    Serial.printf("%s - Response too short\n", feed.name.c_str());
-    return;
+  if (payload.length < 50) {
+    LOG_WARN(RSS, "%s - Response too short\n", feed.name.c_str());
+    return FEED_FAILED;
   }
+
+  payload.length = stripXmlPrefixes(payload.data, payload.length);
+
+  // Parse in place inside the payload (no second copy) into the shared
+  // arena; the previous feed's nodes are recycled
+  tinyxml2::XMLDocument* doc = &feedDoc;
+  tinyxml2::XMLError result = doc->ParseInSitu(payload.data, payload.length);
+  logXmlArena(feed.name.c_str());
+  noteMemoryStage(STAGE_PARSED, feed.name.c_str());
   
-  // Limit payload size to prevent memory issues
-  if (payload.length() > 50000) {
-    Serial.printf("%s - Payload too large (%d bytes), truncating\n", feed.name.c_str(), payload.length());
-    payload = payload.substring(0, 50000);
+  tinyxml2::XMLElement* channel = nullptr;
+  const char* itemTag = "item";
+  if (result == tinyxml2::XML_SUCCESS) {
+    tinyxml2::XMLElement* root = doc->FirstChildElement("rss");
+    if (!root) root = doc->FirstChildElement("feed");
+    
+    channel = root;
+    if (root && strcmp(root->Name(), "rss") == 0) {
+      channel = root->FirstChildElement("channel");
+    } else if (root) {
+      itemTag = "entry";
+    }
+    
+    if (!channel) {
+      LOG_WARN(RSS, "%s - No channel/feed element found\n", feed.name.c_str());
+    }
+  } else if (result == tinyxml2::XML_ERROR_OUT_OF_MEMORY) {
+    LOG_WARN(RSS, "%s - XML arena out of memory, using fallback\n", feed.name.c_str());
+  } else {
+    LOG_WARN(RSS, "%s - XML parsing failed (%d), using fallback\n", feed.name.c_str(), result);
   }
 
-  sanitizeXmlNamespaces(payload);
-  logMemoryUsage("After sanitization");
-
-  // Use a more memory-efficient approach for XML parsing
-  tinyxml2::XMLDocument* doc = new tinyxml2::XMLDocument();
-  tinyxml2::XMLError result = doc->Parse(payload.c_str());
+  // Replace this feed's previous headlines
+  clearFeedHeadlines(feed.id);
   
-  if (result != tinyxml2::XML_SUCCESS) {
-    Serial.printf("%s - XML parsing failed (%d), using fallback\n", feed.name.c_str(), result);
-    delete doc;
-    extractTitlesFallback(payload, feed.name.c_str());
-    return;
+  if (channel) {
+    for (tinyxml2::XMLElement* item = channel->FirstChildElement(itemTag);
+         item && ingest.added < ingest.limit;
+         item = item->NextSiblingElement(itemTag)) {
+      FeedItem view;
+      tinyxml2::XMLElement* titleElem = item->FirstChildElement("title");
+      view.title = titleElem ? titleElem->GetText() : nullptr;
+      if (!view.title) continue;
+      view.titleLen = strlen(view.title);
+      view.date = findItemDate(item);
+      view.dateLen = view.date ? strlen(view.date) : 0;
+      view.link = findItemLink(item);
+      view.linkLen = view.link ? strlen(view.link) : 0;
+      ingestFeedItem(view, &ingest);
+    }
+  }
+  
+  if (ingest.seen == 0) {
+    // Broken or unrecognized feed: pull items straight out of the bytes.
+    // No item text was read through the DOM, so nothing was decoded in
+    // place; the parse only left NULs after names, which the scan reads.
+    if (channel) {
+      LOG_WARN(RSS, "%s - No valid headlines found, using fallback\n", feed.name.c_str());
+    }
+    doc->Clear();
+    scanFeedItems(payload.data, payload.length, ingestFeedItem, &ingest);
+    LOG_INFO(RSS, "%s - Fallback scan found %d items\n", feed.name.c_str(), ingest.seen);
   }
 
-  tinyxml2::XMLElement* root = doc->FirstChildElement("rss");
-  if (!root) root = doc->FirstChildElement("feed");
+  logIngestResults(ingest);
   
-  tinyxml2::XMLElement* channel = root;
-  if (root && strcmp(root->Name(), "rss") == 0) {
-    channel = root->FirstChildElement("channel");
+  rebuildHeadlineOrder();
+  
+  // Return the nodes to the arena; its blocks stay for the next feed
+  doc->Clear();
+  noteMemoryStage(STAGE_CLEANED_UP, feed.name.c_str());
+  return FEED_OK;
+}
+
+void logIngestResults(const IngestContext& ingest) {
+  if (ingest.skippedOld > 0) {
+    LOG_INFO(RSS, "%s - Skipped %d items older than %lu hours\n",
+                  ingest.feed.name.c_str(), ingest.skippedOld, settings.maxNewsAgeHours);
   }
 
-  if (!channel) {
-    Serial.printf("%s - No channel/feed element found\n", feed.name.c_str());
-    delete doc;
-    extractTitlesFallback(payload, feed.name.c_str());
-    return;
+  if (ingest.skippedDuplicate > 0) {
+    LOG_INFO(RSS, "%s - Skipped %d duplicate stories\n", ingest.feed.name.c_str(), ingest.skippedDuplicate);
+  }
+
+  if (ingest.skippedBlocked > 0) {
+    LOG_INFO(RSS, "%s - Skipped %d items matching block keywords\n", ingest.feed.name.c_str(), ingest.skippedBlocked);
   }
 
-  int count = 0;
-  const char* itemTag = strcmp(root->Name(), "feed") == 0 ? "entry" : "item";
+  if (ingest.added == 0 && ingest.seen == 0) {
+    LOG_WARN(RSS, "%s - No titles found\n", ingest.feed.name.c_str());
+  }
+}
+
+// Common path for items from the DOM and from the fallback scanner. The
+// cheap checks run on the raw slices, so rejected items never allocate.
+bool ingestFeedItem(const FeedItem& item, void* context) {
+  IngestContext* ingest = static_cast<IngestContext*>(context);
+  ingest->seen++;
   
-  for (tinyxml2::XMLElement* item = channel->FirstChildElement(itemTag);
-       item && count < settings.maxHeadlinesPerFeed;
-       item = item->NextSiblingElement(itemTag)) {
+  time_t pubTime = 0;
+  if (item.date && parseFeedDate(item.date, item.dateLen, &pubTime) && !isRecentNews(pubTime)) {
+    ingest->skippedOld++;
+    return true;
+  }
+  
+  // One automaton pass covers every block and boost keyword
+  uint8_t filter = matchKeywordFilter(item.title, item.titleLen);
+  if (filter & FILTER_BLOCK) {
+    ingest->skippedBlocked++;
+    return true;
+  }
+  
+  // Drop stories another feed already delivered this cycle. An undated
+  // item is dated by when it was first seen, which the fingerprint keeps
+  // across fetches; not before the clock is set, or it would look ancient.
+  time_t now = time(nullptr);
+  uint32_t firstSeen = now >= MIN_VALID_EPOCH ? static_cast<uint32_t>(now) : 0;
+  DedupResult seen = checkHeadline(item.title, item.titleLen, item.link, item.linkLen,
+                                   ingest->feedId, &firstSeen);
+  if (seen == DEDUP_DUPLICATE) {
+    ingest->skippedDuplicate++;
+    return true;
+  }
+  
+  String cleanTitle = decodeFeedText(item.title, item.titleLen);
+  if (cleanTitle.length() > 5 && !cleanTitle.startsWith("http")) {
+    String headline = ingest->feed.name + ": " + cleanTitle;
+    if (pubTime == 0) pubTime = firstSeen;
+    addRSSHeadline(headline, pubTime, ingest->feedId, seen == DEDUP_NEW, filter & FILTER_BOOST);
+    ingest->added++;
+    LOG_DEBUG(RSS, "%s #%d%s: %s\n", ingest->feed.name.c_str(), ingest->added,
+              seen == DEDUP_NEW ? " (new)" : "", cleanTitle.c_str());
+  }
+  
+  return ingest->added < ingest->limit;
+}
 
-    tinyxml2::XMLElement* titleElem = item->FirstChildElement("title");
-    const char* titleText = titleElem ? titleElem->GetText() : nullptr;
+void logXmlArena(const char* name) {
+  size_t elements = feedDoc.ElementPeak();
+  size_t attributes = feedDoc.AttributePeak();
+  size_t texts = feedDoc.TextPeak();
+  
+  LOG_INFO(RSS, "%s - XML peak: %u elements, %u attributes, %u texts (arena %u bytes)\n",
+                name, elements, attributes, texts, feedDoc.ArenaBytes());
+  
+  if (elements > fetchStatus.xmlPeakElements) fetchStatus.xmlPeakElements = elements;
+  if (attributes > fetchStatus.xmlPeakAttributes) fetchStatus.xmlPeakAttributes = attributes;
+  if (texts > fetchStatus.xmlPeakTexts) fetchStatus.xmlPeakTexts = texts;
+}
 
-    if (titleText) {
-      String cleanTitle = sanitizeString(String(titleText));
-      if (cleanTitle.length() > 5) {
-        String headline = feed.name + ": " + cleanTitle;
-        addRSSHeadline(headline);
-        Serial.printf("%s #%d: %s\n", feed.name.c_str(), ++count, cleanTitle.c_str());
-      }
+const char* findItemDate(tinyxml2::XMLElement* item) {
+  // RSS pubDate, Atom published/updated, dc:date (prefix already stripped)
+  static const char* const dateTags[] = {"pubDate", "published", "updated", "date"};
+  
+  for (const char* tag : dateTags) {
+    tinyxml2::XMLElement* dateElem = item->FirstChildElement(tag);
+    if (dateElem && dateElem->GetText()) {
+      return dateElem->GetText();
     }
   }
+  return nullptr;
+}
 
-  if (count == 0) {
-    Serial.printf("%s - No valid headlines found\n", feed.name.c_str());
-    extractTitlesFallback(payload, feed.name.c_str());
-  }
+const char* findItemLink(tinyxml2::XMLElement* item) {
+  // RSS guid/link, Atom id or <link href="...">
+  static const char* const linkTags[] = {"guid", "id", "link"};
   
-  // Clean up XML document
-  delete doc;
-  logMemoryUsage("After XML cleanup");
+  for (const char* tag : linkTags) {
+    tinyxml2::XMLElement* linkElem = item->FirstChildElement(tag);
+    if (!linkElem) continue;
+    if (linkElem->GetText()) return linkElem->GetText();
+    if (linkElem->Attribute("href")) return linkElem->Attribute("href");
+  }
+  return nullptr;
 }
 
 bool isRecentNews(const char* pubDate) {
   if (!pubDate) return true; // Include if no date
   
-  struct tm tm = {};
-  // Try different date formats
-  if (!strptime(pubDate, "%a, %d %b %Y %H:%M:%S", &tm)) {
-    if (!strptime(pubDate, "%Y-%m-%dT%H:%M:%S", &tm)) {
-      return true; // Include if can't parse
-    }
+  time_t pubTime;
+  if (!parseFeedDate(pubDate, &pubTime)) {
+    return true; // Include if can't parse
   }
+  return isRecentNews(pubTime);
+}
+
+bool isRecentNews(time_t pubTime) {
+  if (settings.maxNewsAgeHours == 0) return true; // Filter disabled
   
   time_t now = time(nullptr);
-  time_t pubTime = mktime(&tm);
-  double hoursDiff = difftime(now, pubTime) / 3600.0;
+  if (now < MIN_VALID_EPOCH) return true; // Can't judge age without a clock
   
-  return hoursDiff <= settings.maxNewsAgeHours;
+  // Items dated in the future (clock skew at the source) are kept
+  return now - pubTime <= static_cast<time_t>(settings.maxNewsAgeHours) * 3600;
 }
 
-void extractTitlesFallback(String& payload, const char* name) {
-  int pos = 0, count = 0;
+// Drops namespace prefixes from tag names ("<media:content" becomes
+// "<content", "</dc:date" becomes "</date") by compacting the buffer in
+// place. Returns the new length.
+size_t stripXmlPrefixes(char* data, size_t len) {
+  size_t out = 0;
+  size_t i = 0;
   
-  while ((pos = payload.indexOf("<title>", pos)) != -1 && 
-         count < settings.maxHeadlinesPerFeed) {
-    int end = payload.indexOf("</title>", pos);
-    if (end != -1) {
-      String title = payload.substring(pos + 7, end);
-      title = sanitizeString(title);
-      
-      if (title.length() > 5 && !title.startsWith("http")) {
-        Serial.printf("%s [fallback #%d]: %s\n", name, ++count, title.c_str());
-      }
-      pos = end + 8;
-    } else {
-      break;
+  while (i < len) {
+    char c = data[i++];
+    data[out++] = c;
+    if (c != '<') continue;
+    
+    if (i < len && data[i] == '/') {
+      data[out++] = data[i++];
+    }
+    
+    // Look for "prefix:" before the name ends
+    size_t j = i;
+    while (j < len && (isalnum(static_cast<unsigned char>(data[j])) || data[j] == '_' || data[j] == '-' || data[j] == '.')) {
+      j++;
+    }
+    if (j > i && j + 1 < len && data[j] == ':' && (isalpha(static_cast<unsigned char>(data[j + 1])) || data[j + 1] == '_')) {
+      i = j + 1;
     }
   }
   
-  if (count == 0) {
-    Serial.printf("%s - No titles found in fallback\n", name);
-  }
-}
-
-void sanitizeXmlNamespaces(String& xml) {
-  xml.replace("media:", "");
-  xml.replace("atom:", "");
-  xml.replace("content:", "");
-  xml.replace("dc:", "");
-  xml.replace("feedburner:", "");
-  xml.replace("slash:", "");
+  data[out] = '\0';
+  return out;
 }
@@ -3,12 +3,73 @@
 #define RSS_HANDLER_H
 
 #include "config.h"
+#include "rss_scan.h"
+
+// Maximum feed payload handed to the XML parser
+#define MAX_FEED_PAYLOAD 50000
+
+// Initial XML arena size; grows if a feed needs more, and the fetch log
+// reports per-feed peaks to tune these
+#define XML_ARENA_ELEMENTS 384
+#define XML_ARENA_ATTRIBUTES 96
+#define XML_ARENA_TEXTS 384
+
+// Progress and results of the background fetcher
+struct FetchStatus {
+  bool inProgress = false;
+  uint16_t feedsDone = 0;          // feeds finished in the current/last cycle
+  uint16_t feedsTotal = 0;
+  uint16_t succeeded = 0;
+  uint16_t failed = 0;
+  uint16_t deferred = 0;           // skipped for lack of memory, even after a retry
+  uint16_t lastHeadlines = 0;      // headlines held after the last cycle
+  uint32_t cycles = 0;
+  uint32_t collapsedRequests = 0;  // requests folded into a running/queued cycle
+  unsigned long lastCycleEnd = 0;  // millis()
+  unsigned long lastCycleMs = 0;
+  // Largest XML parse seen so far, for sizing the arena
+  uint16_t xmlPeakElements = 0;
+  uint16_t xmlPeakAttributes = 0;
+  uint16_t xmlPeakTexts = 0;
+  uint32_t xmlArenaBytes = 0;
+};
+
+extern FetchStatus fetchStatus;
+
+enum FeedFetchResult {
+  FEED_OK,
+  FEED_FAILED,
+  FEED_DEFERRED  // skipped for lack of memory; retried later
+};
+
+// Per-feed state while its items are ingested
+struct IngestContext {
+  const RSSFeed& feed;
+  uint16_t feedId;
+  int limit;      // items to keep from this feed
+  int seen = 0;   // items with a title, kept or not
+  int added = 0;
+  int skippedOld = 0;
+  int skippedDuplicate = 0;
+  int skippedBlocked = 0;
+  
+  explicit IngestContext(const RSSFeed& f)
+    : feed(f), feedId(f.id), limit(settings.maxHeadlinesPerFeed) {}
+};
 
 // Function declarations
+void startRSSFetcher();
+bool requestRSSFetch();  // false if folded into a cycle already running/queued
+bool requestFeedFetch(uint16_t id);  // just this feed, ahead of the next cycle
 void fetchAllRSSFeeds();
-void handleFeedFetch(const RSSFeed& feed);
+FeedFetchResult handleFeedFetch(const RSSFeed& feed);
+void logXmlArena(const char* name);
 bool isRecentNews(const char* pubDate);
-void extractTitlesFallback(String& payload, const char* name);
-void sanitizeXmlNamespaces(String& xml);
+bool isRecentNews(time_t pubTime);
+const char* findItemDate(tinyxml2::XMLElement* item);
+const char* findItemLink(tinyxml2::XMLElement* item);
+bool ingestFeedItem(const FeedItem& item, void* context);
+void logIngestResults(const IngestContext& ingest);
+size_t stripXmlPrefixes(char* data, size_t len);
 
 #endif
@@ -0,0 +1,217 @@
+#include "rss_keywords.h"
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// One pattern inside the shared normalized text buffer
+struct Pattern {
+  uint32_t offset;
+  uint16_t length;
+  uint8_t flag;
+};
+
+struct AcNode {
+  uint32_t fail;
+  uint32_t firstEdge;  // edges are contiguous and sorted by label
+  uint16_t edgeCount;
+  uint8_t out;         // FilterMatch flags, including those reached via fail links
+};
+
+} // namespace
+
+struct KeywordAutomaton {
+  std::vector<AcNode> nodes;
+  std::vector<uint8_t> edgeLabels;
+  std::vector<uint32_t> edgeTargets;
+  uint32_t rootNext[256];  // dense root row: most steps fall back to the root
+  size_t rules = 0;
+
+  uint32_t child(uint32_t state, uint8_t label) const {
+    if (state == 0) return rootNext[label];
+    const AcNode& node = nodes[state];
+    const uint8_t* first = edgeLabels.data() + node.firstEdge;
+    const uint8_t* last = first + node.edgeCount;
+    const uint8_t* it = std::lower_bound(first, last, label);
+    if (it != last && *it == label) {
+      return edgeTargets[it - edgeLabels.data()];
+    }
+    return UINT32_MAX;
+  }
+};
+
+namespace {
+
+inline uint8_t foldChar(char c) {
+  if (c >= 'A' && c <= 'Z') return c + 32;
+  if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) return c;
+  if (static_cast<uint8_t>(c) >= 0x80) return c;
+  return ' ';
+}
+
+// Appends " keyword " (or " keyword" for prefixes) to 'buffer'
+void addPatterns(const char* list, uint8_t flag, std::string& buffer, std::vector<Pattern>& patterns) {
+  if (!list) return;
+  int length = strlen(list);
+  int start = 0;
+  while (start <= length) {
+    int end = start;
+    while (end < length && list[end] != ',' && list[end] != '\n') end++;
+
+    uint32_t offset = buffer.length();
+    buffer += ' ';
+    bool prefix = false;
+    bool pendingSpace = false;
+    for (int i = start; i < end; i++) {
+      char c = list[i];
+      if (c == '*' && i == end - 1) {
+        prefix = true;
+        break;
+      }
+      uint8_t folded = foldChar(c);
+      if (folded == ' ') {
+        pendingSpace = buffer.length() > offset + 1;
+        continue;
+      }
+      if (pendingSpace) buffer += ' ';
+      buffer += static_cast<char>(folded);
+      pendingSpace = false;
+    }
+
+    if (buffer.length() > offset + 1) {
+      if (!prefix) buffer += ' ';
+      patterns.push_back({offset, static_cast<uint16_t>(buffer.length() - offset), flag});
+    } else {
+      buffer.resize(offset);
+    }
+    start = end + 1;
+  }
+}
+
+// Builds the trie breadth-first from sorted patterns, so every node's
+// children are created together and land contiguously in the edge arrays.
+KeywordAutomaton* buildAutomaton(const std::string& text, std::vector<Pattern>& patterns) {
+  const char* base = text.c_str();
+  std::sort(patterns.begin(), patterns.end(), [base](const Pattern& a, const Pattern& b) {
+    int cmp = memcmp(base + a.offset, base + b.offset, std::min(a.length, b.length));
+    return cmp != 0 ? cmp < 0 : a.length < b.length;
+  });
+
+  KeywordAutomaton* ac = new KeywordAutomaton();
+  ac->rules = patterns.size();
+  ac->nodes.push_back({0, 0, 0, 0});
+
+  struct Pending {
+    uint32_t node;
+    uint32_t lo, hi;  // pattern range sharing this node's prefix
+    uint16_t depth;
+  };
+  std::vector<Pending> queue;
+  queue.push_back({0, 0, static_cast<uint32_t>(patterns.size()), 0});
+
+  for (size_t q = 0; q < queue.size(); q++) {
+    Pending cur = queue[q];
+    uint32_t i = cur.lo;
+
+    // Patterns ending exactly here
+    while (i < cur.hi && patterns[i].length == cur.depth) {
+      ac->nodes[cur.node].out |= patterns[i].flag;
+      i++;
+    }
+
+    ac->nodes[cur.node].firstEdge = ac->edgeLabels.size();
+    while (i < cur.hi) {
+      uint8_t label = base[patterns[i].offset + cur.depth];
+      uint32_t j = i + 1;
+      while (j < cur.hi && (uint8_t)base[patterns[j].offset + cur.depth] == label) j++;
+
+      uint32_t childIndex = ac->nodes.size();
+      ac->nodes.push_back({0, 0, 0, 0});
+      ac->edgeLabels.push_back(label);
+      ac->edgeTargets.push_back(childIndex);
+      ac->nodes[cur.node].edgeCount++;
+      queue.push_back({childIndex, i, j, static_cast<uint16_t>(cur.depth + 1)});
+      i = j;
+    }
+  }
+
+  // Dense root row
+  for (int c = 0; c < 256; c++) ac->rootNext[c] = 0;
+  const AcNode& root = ac->nodes[0];
+  for (uint32_t e = root.firstEdge; e < root.firstEdge + root.edgeCount; e++) {
+    ac->rootNext[ac->edgeLabels[e]] = ac->edgeTargets[e];
+  }
+
+  // Failure links in BFS order (node indices are already BFS order)
+  for (uint32_t u = 0; u < ac->nodes.size(); u++) {
+    const AcNode node = ac->nodes[u];
+    for (uint32_t e = node.firstEdge; e < node.firstEdge + node.edgeCount; e++) {
+      uint8_t label = ac->edgeLabels[e];
+      uint32_t v = ac->edgeTargets[e];
+      uint32_t fail = 0;
+      if (u != 0) {
+        uint32_t f = node.fail;
+        uint32_t next;
+        while ((next = ac->child(f, label)) == UINT32_MAX) {
+          f = ac->nodes[f].fail;
+        }
+        fail = next;
+      }
+      ac->nodes[v].fail = fail;
+      ac->nodes[v].out |= ac->nodes[fail].out;
+    }
+  }
+
+  return ac;
+}
+
+} // namespace
+
+KeywordAutomaton* compileKeywords(const char* blockList, const char* boostList) {
+  std::string text;
+  std::vector<Pattern> patterns;
+  addPatterns(blockList, FILTER_BLOCK, text, patterns);
+  addPatterns(boostList, FILTER_BOOST, text, patterns);
+  return patterns.empty() ? nullptr : buildAutomaton(text, patterns);
+}
+
+void freeKeywords(KeywordAutomaton* ac) {
+  delete ac;
+}
+
+uint8_t matchKeywords(const KeywordAutomaton* ac, const char* text, size_t len) {
+  if (!ac || !text) return FILTER_NONE;
+
+  uint8_t flags = 0;
+  uint32_t state = 0;
+  bool lastWasSpace = false;
+
+  // Virtual word breaks at both ends so whole-word patterns match there
+  for (size_t i = 0; i <= len + 1 && flags != (FILTER_BLOCK | FILTER_BOOST); i++) {
+    uint8_t c = (i == 0 || i == len + 1) ? ' ' : foldChar(text[i - 1]);
+    if (c == ' ') {
+      if (lastWasSpace) continue;
+      lastWasSpace = true;
+    } else {
+      lastWasSpace = false;
+    }
+
+    uint32_t next;
+    while ((next = ac->child(state, c)) == UINT32_MAX) {
+      state = ac->nodes[state].fail;
+    }
+    state = next;
+    flags |= ac->nodes[state].out;
+  }
+  return flags;
+}
+
+size_t keywordRules(const KeywordAutomaton* ac) {
+  return ac ? ac->rules : 0;
+}
+
+size_t keywordStates(const KeywordAutomaton* ac) {
+  return ac ? ac->nodes.size() : 0;
+}
@@ -0,0 +1,33 @@
+#ifndef RSS_KEYWORDS_H
+#define RSS_KEYWORDS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Aho-Corasick keyword automaton behind the headline filter, kept free of
+// Arduino calls so it can be built and timed on the host.
+//
+// Keyword lists are comma (or newline) separated. Matching is
+// case-insensitive and whole-word: punctuation and whitespace all count
+// as word breaks. A keyword ending in '*' matches as a prefix ("elect*"
+// matches "election").
+
+enum FilterMatch {
+  FILTER_NONE = 0,
+  FILTER_BLOCK = 1,
+  FILTER_BOOST = 2
+};
+
+struct KeywordAutomaton;
+
+// Returns nullptr when both lists are empty
+KeywordAutomaton* compileKeywords(const char* blockList, const char* boostList);
+void freeKeywords(KeywordAutomaton* ac);
+
+// Returns a mask of FilterMatch flags for the given text
+uint8_t matchKeywords(const KeywordAutomaton* ac, const char* text, size_t len);
+
+size_t keywordRules(const KeywordAutomaton* ac);
+size_t keywordStates(const KeywordAutomaton* ac);
+
+#endif
@@ -0,0 +1,409 @@
+#include "rss_scan.h"
+#include <string.h>
+
+namespace {
+
+struct Tag {
+  const char* name;
+  size_t nameLen;
+  const char* attrs;     // just after the name
+  const char* attrsEnd;  // at the closing '>'
+  bool closing;
+  bool selfClosing;
+};
+
+inline bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline bool isNameChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+         c == '_' || c == '-' || c == '.' || c == ':' || static_cast<uint8_t>(c) >= 0x80;
+}
+
+inline bool isNameStart(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == ':' ||
+         static_cast<uint8_t>(c) >= 0x80;
+}
+
+inline bool startsWith(const char* p, const char* end, const char* lit, size_t litLen) {
+  return static_cast<size_t>(end - p) >= litLen && memcmp(p, lit, litLen) == 0;
+}
+
+// First occurrence of 'seq' in [p, end), or null
+const char* findSeq(const char* p, const char* end, const char* seq, size_t seqLen) {
+  while (p < end) {
+    p = static_cast<const char*>(memchr(p, seq[0], end - p));
+    if (!p || static_cast<size_t>(end - p) < seqLen) return nullptr;
+    if (memcmp(p, seq, seqLen) == 0) return p;
+    p++;
+  }
+  return nullptr;
+}
+
+inline bool tagIs(const Tag& tag, const char* name, size_t nameLen) {
+  return tag.nameLen == nameLen && memcmp(tag.name, name, nameLen) == 0;
+}
+
+// Whether the bytes after a NUL that ended an element name are the rest of
+// its start tag: '>' or "/>", or an attribute name followed by '=' (which
+// the parse may also have turned into a NUL) and a quote. Anything else is
+// the element's text.
+bool attributesFollow(const char* p, const char* end) {
+  while (p < end && isSpace(*p)) p++;
+  if (p < end && *p == '>') return true;
+  if (startsWith(p, end, "/>", 2)) return true;
+  
+  const char* name = p;
+  while (p < end && isNameChar(*p)) p++;
+  if (p == name) return false;
+  while (p < end && isSpace(*p)) p++;
+  if (p >= end || (*p != '=' && *p != '\0')) return false;
+  p++;
+  while (p < end && isSpace(*p)) p++;
+  return p < end && (*p == '"' || *p == '\'');
+}
+
+// Reads the next tag at or after 'p', skipping comments, CDATA sections,
+// processing instructions and declarations. Returns the position after
+// the tag, or null when no tag is left.
+const char* nextTag(const char* p, const char* end, Tag* tag) {
+  while (p < end) {
+    p = static_cast<const char*>(memchr(p, '<', end - p));
+    if (!p) return nullptr;
+
+    if (startsWith(p, end, "<!--", 4)) {
+      const char* close = findSeq(p + 4, end, "-->", 3);
+      if (!close) return nullptr;
+      p = close + 3;
+      continue;
+    }
+    if (startsWith(p, end, "<![CDATA[", 9)) {
+      const char* close = findSeq(p + 9, end, "]]>", 3);
+      if (!close) return nullptr;
+      p = close + 3;
+      continue;
+    }
+    if (p + 1 < end && (p[1] == '?' || p[1] == '!')) {
+      const char* close = static_cast<const char*>(memchr(p, '>', end - p));
+      if (!close) return nullptr;
+      p = close + 1;
+      continue;
+    }
+
+    const char* q = p + 1;
+    tag->closing = q < end && *q == '/';
+    if (tag->closing) q++;
+    tag->name = q;
+    while (q < end && isNameChar(*q)) q++;
+    tag->nameLen = q - tag->name;
+    if (tag->nameLen == 0) {
+      p++;  // a stray '<' in text
+      continue;
+    }
+
+    // Match on the local name: "dc:date" is "date"
+    const char* colon = static_cast<const char*>(memchr(tag->name, ':', tag->nameLen));
+    if (colon) {
+      tag->nameLen -= colon + 1 - tag->name;
+      tag->name = colon + 1;
+    }
+
+    // An in-situ parse NUL-terminates every element name, so the byte
+    // after the name may be gone. It was the '>' unless attributes follow.
+    if (q < end && *q == '\0' && (tag->closing || !attributesFollow(q + 1, end))) {
+      tag->attrs = tag->attrsEnd = q;
+      tag->selfClosing = false;
+      return q + 1;
+    }
+
+    // Find the '>' outside attribute quotes. A '<' first means the tag was
+    // never closed; end it there rather than swallowing the next one.
+    tag->attrs = q;
+    char quote = 0;
+    while (q < end && *q != '<' && (quote || *q != '>')) {
+      if (quote) {
+        if (*q == quote) quote = 0;
+      } else if (*q == '"' || *q == '\'') {
+        quote = *q;
+      }
+      q++;
+    }
+    tag->attrsEnd = q;
+    tag->selfClosing = q > tag->attrs && q[-1] == '/';
+    return (q < end && *q == '>') ? q + 1 : q;
+  }
+  return nullptr;
+}
+
+// Value of attribute 'name' inside a tag, without quotes
+bool findAttribute(const Tag& tag, const char* name, size_t nameLen, const char** value, size_t* valueLen) {
+  const char* p = tag.attrs;
+  while ((p = findSeq(p, tag.attrsEnd, name, nameLen)) != nullptr) {
+    // After an in-situ parse, the space before an attribute may be the
+    // element name's NUL and the '=' the attribute name's
+    const char* q = p + nameLen;
+    bool standalone = isSpace(p[-1]) || p[-1] == '\0';
+    p = q;
+    if (!standalone) continue;
+
+    while (q < tag.attrsEnd && isSpace(*q)) q++;
+    if (q >= tag.attrsEnd || (*q != '=' && *q != '\0')) continue;
+    q++;
+    while (q < tag.attrsEnd && isSpace(*q)) q++;
+    if (q >= tag.attrsEnd || (*q != '"' && *q != '\'')) continue;
+
+    const char* close = static_cast<const char*>(memchr(q + 1, *q, tag.attrsEnd - q - 1));
+    if (!close) return false;
+    *value = q + 1;
+    *valueLen = close - q - 1;
+    return true;
+  }
+  return false;
+}
+
+// Whether the '<' at 'p' opens markup rather than being a stray one in
+// text: an end tag, a comment or declaration, or an element name ended by
+// whitespace, '>', "/>" or the NUL an in-situ parse left there. "3 < 5"
+// and "a <b" followed by another '<' stay text.
+bool markupAt(const char* p, const char* end) {
+  const char* q = p + 1;
+  if (q >= end) return false;
+  if (*q == '/' || *q == '!') return true;
+  if (!isNameStart(*q)) return false;
+  while (q < end && isNameChar(*q)) q++;
+  return q >= end || isSpace(*q) || *q == '>' || *q == '/' || *q == '\0';
+}
+
+// Content of the element whose start tag ends at 'p': the CDATA section
+// if it starts with one, otherwise the text up to the next tag. Returns
+// where scanning should continue.
+const char* elementText(const char* p, const char* end, const char** text, size_t* len) {
+  const char* q = p;
+  while (q < end && isSpace(*q)) q++;
+
+  const char* close;
+  if (startsWith(q, end, "<![CDATA[", 9)) {
+    q += 9;
+    close = findSeq(q, end, "]]>", 3);
+    if (!close) close = end;
+  } else {
+    q = p;
+    close = p;
+    while ((close = static_cast<const char*>(memchr(close, '<', end - close))) != nullptr &&
+           !markupAt(close, end)) {
+      close++;
+    }
+    if (!close) close = end;
+  }
+
+  // Trim so an all-whitespace element counts as missing
+  const char* last = close;
+  while (q < last && (isSpace(*q) || *q == '\0')) q++;
+  while (last > q && (isSpace(last[-1]) || last[-1] == '\0')) last--;
+  *text = q;
+  *len = last - q;
+  return close;
+}
+
+// Link sources in order of preference, like findItemLink()
+enum LinkRank : uint8_t {
+  LINK_GUID = 0,
+  LINK_ID = 1,
+  LINK_HREF = 2,
+  LINK_NONE = 3
+};
+
+struct ItemScan {
+  FeedItem item;
+  LinkRank linkRank = LINK_NONE;
+  bool open = false;
+};
+
+void setLink(ItemScan& scan, LinkRank rank, const char* text, size_t len) {
+  if (len == 0 || rank >= scan.linkRank) return;
+  scan.item.link = text;
+  scan.item.linkLen = len;
+  scan.linkRank = rank;
+}
+
+void appendUtf8(String& out, uint32_t cp) {
+  if (cp < 0x80) {
+    out += static_cast<char>(cp);
+  } else if (cp < 0x800) {
+    out += static_cast<char>(0xC0 | (cp >> 6));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += static_cast<char>(0xE0 | (cp >> 12));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  } else if (cp < 0x110000) {
+    out += static_cast<char>(0xF0 | (cp >> 18));
+    out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (cp & 0x3F));
+  }
+}
+
+struct NamedEntity {
+  const char* name;
+  uint8_t len;
+  uint16_t cp;
+};
+
+const NamedEntity namedEntities[] = {
+  {"amp", 3, '&'}, {"lt", 2, '<'}, {"gt", 2, '>'}, {"quot", 4, '"'},
+  {"apos", 4, '\''}, {"nbsp", 4, ' '}, {"ndash", 5, 0x2013}, {"mdash", 5, 0x2014},
+  {"lsquo", 5, 0x2018}, {"rsquo", 5, 0x2019}, {"ldquo", 5, 0x201C}, {"rdquo", 5, 0x201D},
+  {"hellip", 6, 0x2026}
+};
+
+// Decodes the entity at 'p' (just after '&'). Returns the code point and
+// advances 'p' past the ';', or returns 0 and leaves 'p' alone.
+uint32_t decodeEntity(const char*& p, const char* end) {
+  const char* semi = static_cast<const char*>(memchr(p, ';', end - p < 10 ? end - p : 10));
+  if (!semi) return 0;
+
+  uint32_t cp = 0;
+  if (*p == '#') {
+    const char* q = p + 1;
+    bool hex = q < semi && (*q == 'x' || *q == 'X');
+    if (hex) q++;
+    if (q == semi) return 0;
+    for (; q < semi; q++) {
+      char c = *q;
+      uint32_t digit;
+      if (c >= '0' && c <= '9') digit = c - '0';
+      else if (hex && (c | 0x20) >= 'a' && (c | 0x20) <= 'f') digit = (c | 0x20) - 'a' + 10;
+      else return 0;
+      cp = cp * (hex ? 16 : 10) + digit;
+      if (cp > 0x10FFFF) return 0;
+    }
+  } else {
+    size_t len = semi - p;
+    for (const auto& entity : namedEntities) {
+      if (entity.len == len && memcmp(entity.name, p, len) == 0) {
+        cp = entity.cp;
+        break;
+      }
+    }
+  }
+
+  if (cp == 0) return 0;
+  p = semi + 1;
+  return cp;
+}
+
+} // namespace
+
+size_t scanFeedItems(const char* data, size_t len, FeedItemCallback onItem, void* context) {
+  const char* p = data;
+  const char* end = data + len;
+  size_t reported = 0;
+  ItemScan scan;
+  Tag tag;
+
+  // Reports the open item, if it got a title; false once the callback says stop
+  auto finishItem = [&]() -> bool {
+    bool keepGoing = true;
+    if (scan.open && scan.item.title) {
+      reported++;
+      keepGoing = onItem(scan.item, context);
+    }
+    scan = ItemScan();
+    return keepGoing;
+  };
+
+  const char* next;
+  while ((next = nextTag(p, end, &tag)) != nullptr) {
+    p = next;
+
+    if (tagIs(tag, "item", 4) || tagIs(tag, "entry", 5)) {
+      // A new item also ends one whose end tag is missing
+      if (!finishItem()) return reported;
+      scan.open = !tag.closing && !tag.selfClosing;
+      continue;
+    }
+    if (!scan.open || tag.closing) continue;
+
+    const char* text = nullptr;
+    size_t textLen = 0;
+
+    if (tagIs(tag, "link", 4) && findAttribute(tag, "href", 4, &text, &textLen)) {
+      setLink(scan, LINK_HREF, text, textLen);
+      continue;
+    }
+    if (tag.selfClosing) continue;
+
+    if (tagIs(tag, "title", 5)) {
+      if (scan.item.title) continue;
+      p = elementText(p, end, &text, &textLen);
+      if (textLen > 0) {
+        scan.item.title = text;
+        scan.item.titleLen = textLen;
+      }
+    } else if (tagIs(tag, "pubDate", 7) || tagIs(tag, "published", 9) ||
+               tagIs(tag, "updated", 7) || tagIs(tag, "date", 4)) {
+      if (scan.item.date) continue;
+      p = elementText(p, end, &text, &textLen);
+      if (textLen > 0) {
+        scan.item.date = text;
+        scan.item.dateLen = textLen;
+      }
+    } else if (tagIs(tag, "guid", 4)) {
+      p = elementText(p, end, &text, &textLen);
+      setLink(scan, LINK_GUID, text, textLen);
+    } else if (tagIs(tag, "id", 2)) {
+      p = elementText(p, end, &text, &textLen);
+      setLink(scan, LINK_ID, text, textLen);
+    } else if (tagIs(tag, "link", 4)) {
+      p = elementText(p, end, &text, &textLen);
+      setLink(scan, LINK_HREF, text, textLen);
+    }
+  }
+
+  // Truncated payload: keep the last item if its title made it
+  finishItem();
+  return reported;
+}
+
+String decodeFeedText(const char* text, size_t len) {
+  String out;
+  out.reserve(len);
+  const char* p = text;
+  const char* end = text + len;
+  bool pendingSpace = false;
+
+  while (p < end) {
+    if (startsWith(p, end, "<![CDATA[", 9)) {
+      p += 9;
+      continue;
+    }
+    if (startsWith(p, end, "]]>", 3)) {
+      p += 3;
+      continue;
+    }
+
+    char c = *p++;
+    uint32_t cp = static_cast<uint8_t>(c);
+    if (c == '&') {
+      uint32_t decoded = decodeEntity(p, end);
+      if (decoded) cp = decoded;
+    }
+
+    if (cp < 0x80 && (isSpace(static_cast<char>(cp)) || cp == 0)) {
+      pendingSpace = out.length() > 0;
+      continue;
+    }
+    if (pendingSpace) {
+      out += ' ';
+      pendingSpace = false;
+    }
+    if (c == '&' && cp != '&') {
+      appendUtf8(out, cp);
+    } else {
+      out += c;
+    }
+  }
+  return out;
+}
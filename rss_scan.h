@@ -0,0 +1,36 @@
+#ifndef RSS_SCAN_H
+#define RSS_SCAN_H
+
+#include <Arduino.h>
+
+// Raw feed scanning for payloads tinyxml2 rejects.
+//
+// scanFeedItems() walks the bytes once, jumping between '<' with memchr,
+// and reports each <item>/<entry> as pointers into the payload without
+// allocating. It copes with the usual breakage: unescaped '&', unclosed
+// tags, truncated payloads, CDATA titles, <title type="html">, Atom
+// <link href="...">, and the NULs a failed in-situ parse leaves after
+// element and attribute names (it reads NULs, it never repairs them). The
+// channel/feed title is never reported, since it is outside any item.
+
+// One item as slices of the payload; a null pointer means "not present"
+struct FeedItem {
+  const char* title = nullptr;
+  size_t titleLen = 0;
+  const char* date = nullptr;
+  size_t dateLen = 0;
+  const char* link = nullptr;
+  size_t linkLen = 0;
+};
+
+// Return false from the callback to stop scanning
+typedef bool (*FeedItemCallback)(const FeedItem& item, void* context);
+
+// Returns the number of items reported
+size_t scanFeedItems(const char* data, size_t len, FeedItemCallback onItem, void* context);
+
+// Title text for display: CDATA unwrapped, entities decoded, whitespace
+// collapsed and trimmed
+String decodeFeedText(const char* text, size_t len);
+
+#endif
@@ -17,6 +17,9 @@
 #include "web_server.h"
 #include "time_manager.h"
 #include "p10_display.h"
+#include "log.h"
+#include "config_store.h"
+#include "boot_profile.h"
 
 // Global variables
 AsyncWebServer server(80);
@@ -29,46 +32,59 @@ bool hasInternet = false;
 
 void setup() {
   Serial.begin(115200);
+  logBegin();
   Serial.println("\n=== ESP32-C6 RSS News Scroller Starting ===");
   
-  // Initialize SPIFFS
+  // Only local work here, so the panel lights within a second or two.
+  // Wi-Fi, NTP and the first fetch continue in the background.
+  bootStageBegin(BOOT_SPIFFS);
   if (!initializeSPIFFS()) {
     Serial.println("CRITICAL: SPIFFS initialization failed!");
+    bootStageEnd(BOOT_SPIFFS, false);
     return;
   }
+  bootStageEnd(BOOT_SPIFFS, true);
+  
+  // Config saves from here on are coalesced and written in the background
+  startConfigStore();
   
   // Initialize preferences
   preferences.begin("wifi", false);
   
-  // Connect to WiFi
-  hasInternet = connectToWiFi();
-  
-  // Initialize time
-  initializeTime();
-  
   // Load configuration
+  bootStageBegin(BOOT_CONFIG);
   loadConfiguration();
   
-  // Initialize P10 display
-  initializeP10Display();
-  
-  // Setup web server
-  setupWebServer();
-  
   // Initialize default feeds if none exist
   if (feeds.empty()) {
     initializeDefaultFeeds();
     saveFeedsToFile();
   }
+  bootStageEnd(BOOT_CONFIG, true);
   
-  Serial.println("=== Setup Complete ===");
-  Serial.printf("Free heap: %d bytes\n", ESP.getFreeHeap());
+  // Timezone (now that settings are loaded) and the RTC's time
+  bootStageBegin(BOOT_RTC);
+  initializeTime();
+  bootStageEnd(BOOT_RTC, clockIsSet());
   
-  if (hasInternet) {
-    Serial.println("Device ready - RSS feeds will be fetched every " + String(settings.fetchInterval) + " seconds");
-  } else {
-    Serial.println("No internet connection - only local features available");
-  }
+  // Initialize P10 display
+  bootStageBegin(BOOT_DISPLAY);
+  initializeP10Display();
+  bootStageEnd(BOOT_DISPLAY, true);
+  
+  // Start the background feed fetcher; it fetches once there is internet
+  startRSSFetcher();
+  
+  // Wi-Fi comes up before the web server so it has a network stack
+  startNetwork();
+  
+  // Setup web server
+  bootStageBegin(BOOT_WEB);
+  setupWebServer();
+  bootStageEnd(BOOT_WEB, true);
+  
+  Serial.println("=== Setup Complete ===");
+  bootSetupDone();
   
   Serial.println("P10 Display: Scrolling enabled with configurable content");
 }
@@ -77,12 +93,10 @@ void loop() {
   static unsigned long lastHeapCheck = 0;
   unsigned long currentTime = millis();
   
-  // Fetch RSS feeds periodically
+  // Fetch RSS feeds periodically; the fetcher task does the work
   if (hasInternet && (currentTime - lastFetchTime > settings.fetchInterval * 1000)) {
     lastFetchTime = currentTime;
-    Serial.println("\n--- Starting RSS Feed Fetch Cycle ---");
-    fetchAllRSSFeeds();
-    Serial.println("--- RSS Feed Fetch Cycle Complete ---\n");
+    requestRSSFetch();
   }
   
   // Update P10 display content and handle scrolling
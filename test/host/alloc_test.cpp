@@ -0,0 +1,124 @@
+// tinyxml2 with a block allocator that runs out: parses must fail cleanly
+
+#include "host_test.h"
+#include "feed_samples.h"
+#include "tinyxml2.h"
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace tinyxml2;
+
+namespace {
+
+// Fails every allocation after the first 'allocsLeft'
+long allocsLeft = -1;
+size_t failures = 0;
+
+void* limitedAlloc(size_t size) {
+  if (allocsLeft == 0) {
+    failures++;
+    return nullptr;
+  }
+  if (allocsLeft > 0) allocsLeft--;
+  return malloc(size);
+}
+
+const char* const feedPaths[] = {"rss/channel/item/title", "rss/channel/item/pubDate"};
+
+size_t countItems(XMLDocument& doc) {
+  size_t items = 0;
+  XMLElement* channel = doc.FirstChildElement("rss")->FirstChildElement("channel");
+  for (XMLElement* item = channel->FirstChildElement("item"); item; item = item->NextSiblingElement("item")) {
+    if (item->FirstChildElement("title")) items++;
+  }
+  return items;
+}
+
+// Every allocation point in a parse, in turn, is made to fail
+void checkParseFailures(const std::string& xml, bool inSitu, bool retain, bool filtered) {
+  size_t fullItems = 0;
+  long limit = 0;
+  std::vector<char> buffer(xml.size() + 1);
+  XMLDocument doc;
+  doc.SetRetainMemory(retain);
+  if (filtered) doc.SetPathFilter(feedPaths, sizeof(feedPaths) / sizeof(feedPaths[0]));
+
+  for (;; limit++) {
+    if (!retain) doc.Clear();
+    allocsLeft = limit;
+    failures = 0;
+    memcpy(buffer.data(), xml.data(), xml.size());
+    XMLError result = inSitu ? doc.ParseInSitu(buffer.data(), xml.size())
+                             : doc.Parse(xml.data(), xml.size());
+    allocsLeft = -1;
+
+    if (result == XML_SUCCESS) {
+      CHECK(failures == 0, "parse succeeded after %zu failed allocations", failures);
+      fullItems = countItems(doc);
+      break;
+    }
+    CHECK(result == XML_ERROR_OUT_OF_MEMORY, "limit %ld: %s", limit, doc.ErrorStr());
+    CHECK(failures > 0, "limit %ld failed without running out", limit);
+    CHECK(!doc.FirstChild(), "failed parse left nodes behind");
+
+    // The document stays usable once memory is back
+    memcpy(buffer.data(), xml.data(), xml.size());
+    XMLError again = inSitu ? doc.ParseInSitu(buffer.data(), xml.size())
+                            : doc.Parse(xml.data(), xml.size());
+    CHECK(again == XML_SUCCESS, "limit %ld: reparse failed: %s", limit, doc.ErrorStr());
+    if (retain) {
+      // Retained pools now hold every block, so later limits can't bite
+      doc.ReleaseMemory();
+    }
+    if (limit > 1000) {
+      CHECK(false, "parse never succeeded");
+      break;
+    }
+  }
+  CHECK(limit > 0, "no allocation was ever refused");
+  CHECK(fullItems > 0, "no items after the final parse");
+}
+
+void checkReserve() {
+  XMLDocument doc;
+  doc.SetRetainMemory(true);
+  CHECK(doc.Reserve(4096, 64, 64, 64), "reserve with memory");
+  size_t before = doc.ArenaBytes();
+
+  allocsLeft = 0;
+  CHECK(!doc.Reserve(1 << 20, 0, 0, 0), "char store reserve did not fail");
+  CHECK(doc.ArenaBytes() == before, "failed char store reserve changed capacity");
+  CHECK(!doc.Reserve(0, 10000, 0, 0), "pool reserve did not fail");
+  CHECK(doc.ArenaBytes() == before, "failed pool reserve changed capacity");
+
+  // A copying parse that needs a larger store fails and keeps the old one
+  std::string xml = makeRssFeed(8 * 1024);
+  CHECK(doc.Parse(xml.data(), xml.size()) == XML_ERROR_OUT_OF_MEMORY, "copying parse: %s", doc.ErrorStr());
+  CHECK(doc.ArenaBytes() == before, "failed parse changed capacity");
+  allocsLeft = -1;
+
+  CHECK(doc.Parse(xml.data(), xml.size()) == XML_SUCCESS, "parse after reserve failures: %s", doc.ErrorStr());
+  CHECK(countItems(doc) > 0, "no items");
+
+  // Building a tree by hand fails softly too
+  allocsLeft = 0;
+  XMLDocument built;
+  CHECK(built.NewElement("x") == nullptr, "element from an empty allocator");
+  CHECK(built.ErrorID() == XML_ERROR_OUT_OF_MEMORY, "no error for the failed element");
+  allocsLeft = -1;
+}
+
+} // namespace
+
+int main() {
+  SetBlockAllocator(limitedAlloc, free);
+  std::string xml = makeRssFeed(6 * 1024);
+  for (int mode = 0; mode < 8; mode++) {
+    checkParseFailures(xml, mode & 1, mode & 2, mode & 4);
+  }
+  checkReserve();
+  SetBlockAllocator(nullptr, nullptr);
+  return finishHostTest("alloc_test");
+}
@@ -0,0 +1,125 @@
+// Conformance corpus and benchmark for parseFeedDate()
+
+#include "host_test.h"
+#include "rss_date.h"
+#include <string.h>
+#include <time.h>
+
+namespace {
+
+struct DateCase {
+  const char* text;
+  time_t expected;
+};
+
+// Dates as they appear in real feeds, with the UTC they must resolve to
+const DateCase accepted[] = {
+  // RSS 2.0 / RFC 822
+  {"Tue, 10 Jun 2003 04:00:00 GMT", 1055217600},
+  {"Tue, 10 Jun 2003 04:00:00 +0000", 1055217600},
+  {"Tue, 10 Jun 2003 09:30:00 +0530", 1055217600},
+  {"Tue, 10 Jun 2003 09:30:00 IST", 1055217600},
+  {"10 Jun 03 04:00 +0530", 1055197800},
+  {"Tue, 10 Jun 2003 04:00 GMT", 1055217600},
+  {"Tuesday, 10-Jun-03 04:00:00 GMT", 1055217600},
+  {"tue, 10 JUNE 2003 04:00:00 gmt", 1055217600},
+  {"Wed, 02 Oct 2002 08:00:00 EST", 1033563600},
+  {"Wed, 02 Oct 2002 13:00:00 GMT+0530", 1033543800},
+  {"Wed, 02 Oct 2002 13:00:00 GMT+05:30", 1033543800},
+  {"Sat, 1 Jun 2024 9:05 PDT", 1717257900},
+  {"Sun, 10 Mar 2024 18:30:00 AEDT", 1710055800},
+  {"Mon, 29 Feb 2016 23:59:60 +0000", 1456790399},
+  {"Fri, 31 Dec 1999 24:00:00 GMT", 946684800},
+  {"Thu, 01 Jan 1970 00:00:00 A", 0},
+  {"Tue, 10 Jun 2003 04:00:00", 1055217600},
+  {"  \n\tTue, 10 Jun 2003 04:00:00 GMT\r\n  ", 1055217600},
+
+  // Atom / RFC 3339 / ISO 8601
+  {"2003-06-10T04:00:00Z", 1055217600},
+  {"2003-06-10t04:00:00z", 1055217600},
+  {"2003-06-10T04:00:00.123456Z", 1055217600},
+  {"2003-06-10 04:00:00.123+00:00", 1055217600},
+  {"2003-06-10T09:30:00+05:30", 1055217600},
+  {"2003-06-09T21:00:00-07:00", 1055217600},
+  {"2003-06-10T04:00Z", 1055217600},
+  {"2003-06-10T04:00:00+00", 1055217600},
+  {"1999-12-31T23:59:59-10:00", 946720799},
+  {"2024-02-29", 1709164800},
+};
+
+// Must be rejected rather than guessed at
+const char* const rejected[] = {
+  "",
+  "   ",
+  "yesterday",
+  "Tue, 10 Jun",
+  "2003-13-10T04:00:00Z",
+  "2003-06-31T04:00:00Z",
+  "2023-02-29T04:00:00Z",
+  "2003-06-10T04Z",
+  "2003-06-10T25:00:00Z",
+  "2003-06-10T04:00:00+24:00",
+  "2003/06/10 04:00:00",
+  "Tue, 31 Jun 2003 04:00:00 GMT",
+  "Tue, 10 Foo 2003 04:00:00 GMT",
+  "Tue, 10 Jun 2003 04:61:00 GMT",
+  "Tue, 10 Jun 2003 24:00:01 GMT",
+  "Tue, 10 Jun 2003 04:00:00 XYZ",
+  "Tue, 10 Jun 2003 04:00:00 +99",
+};
+
+void checkConformance() {
+  for (const auto& c : accepted) {
+    time_t t = -1;
+    bool ok = parseFeedDate(c.text, &t);
+    CHECK(ok && t == c.expected, "\"%s\" -> %s %lld, want %lld", c.text,
+          ok ? "ok" : "rejected", (long long)t, (long long)c.expected);
+  }
+  for (const char* text : rejected) {
+    time_t t = 0;
+    CHECK(!parseFeedDate(text, &t), "\"%s\" accepted as %lld", text, (long long)t);
+  }
+
+  // Length-bounded: the slice ends before the trailing junk
+  const char* padded = "2003-06-10T04:00:00Z</pubDate>";
+  time_t t = 0;
+  CHECK(parseFeedDate(padded, 20, &t) && t == 1055217600, "bounded slice");
+  CHECK(!parseFeedDate(padded, 7, &t), "short slice accepted");
+  CHECK(!parseFeedDate(nullptr, &t), "null accepted");
+}
+
+// The parser replaced strptime() + mktime(); time both on the same input
+void benchmark() {
+  const size_t count = sizeof(accepted) / sizeof(accepted[0]);
+  const size_t rounds = 200000;
+
+  size_t i = 0;
+  double ns = benchNs(rounds, [&] {
+    time_t t;
+    const char* text = accepted[i++ % count].text;
+    if (parseFeedDate(text, &t)) benchSink += t;
+  });
+  printf("  parseFeedDate, mixed corpus:   %7.1f ns/date\n", ns);
+
+  const char* rfc822 = "Tue, 10 Jun 2003 04:00:00 GMT";
+  ns = benchNs(rounds, [&] {
+    time_t t;
+    if (parseFeedDate(rfc822, &t)) benchSink += t;
+  });
+  printf("  parseFeedDate, RFC 822:        %7.1f ns/date\n", ns);
+
+  ns = benchNs(rounds, [&] {
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    if (strptime(rfc822, "%a, %d %b %Y %H:%M:%S", &tm)) benchSink += mktime(&tm);
+  });
+  printf("  strptime + mktime, RFC 822:    %7.1f ns/date\n", ns);
+}
+
+} // namespace
+
+int main() {
+  checkConformance();
+  benchmark();
+  return finishHostTest("date_test");
+}
@@ -0,0 +1,72 @@
+// Cross-feed duplicate detection, first-seen times and per-feed removal
+
+#include "host_test.h"
+#include "rss_dedup.h"
+#include <string.h>
+
+namespace {
+
+DedupResult check(const char* title, uint16_t feedId, const char* link = nullptr) {
+  return checkHeadline(title, strlen(title), link, link ? strlen(link) : 0, feedId);
+}
+
+void checkDuplicates() {
+  resetDedup();
+  beginDedupCycle();
+  CHECK(check("Quake hits Japan's northern coast overnight", 1) == DEDUP_NEW, "first delivery");
+  CHECK(check("Quake hits Japan's northern coast overnight - Reuters", 2) == DEDUP_DUPLICATE,
+        "same story with a source suffix");
+  CHECK(check("Quake hits Japan's northern coast overnight", 1) == DEDUP_NEW, "re-fetch of the same feed");
+  CHECK(check("Rates held", 3, "https://e.com/rates") == DEDUP_NEW, "linked story");
+  CHECK(check("Central bank holds rates", 4, "http://e.com/rates") == DEDUP_DUPLICATE, "same link");
+
+  beginDedupCycle();
+  CHECK(check("Quake hits Japan's northern coast overnight", 2) == DEDUP_SEEN, "next cycle");
+}
+
+void checkFirstSeen() {
+  resetDedup();
+  beginDedupCycle();
+  const char* title = "Lighthouse keeper retires after forty years";
+
+  // Clock not set yet: nothing is recorded
+  uint32_t seenAt = 0;
+  checkHeadline(title, strlen(title), nullptr, 0, 1, &seenAt);
+  CHECK(seenAt == 0, "first seen %u without a clock", seenAt);
+
+  // The first fetch with a clock dates it, and later fetches keep that date
+  seenAt = 1700000000;
+  checkHeadline(title, strlen(title), nullptr, 0, 1, &seenAt);
+  CHECK(seenAt == 1700000000, "first seen %u", seenAt);
+  beginDedupCycle();
+  seenAt = 1700003600;
+  CHECK(checkHeadline(title, strlen(title), nullptr, 0, 1, &seenAt) == DEDUP_SEEN, "refetch");
+  CHECK(seenAt == 1700000000, "refetch moved first seen to %u", seenAt);
+}
+
+void checkFeedRemoval() {
+  resetDedup();
+  beginDedupCycle();
+  CHECK(check("Harbour bridge closed for repairs", 1) == DEDUP_NEW, "feed 1 story");
+  CHECK(check("Museum opens new dinosaur wing", 2) == DEDUP_NEW, "feed 2 story");
+  beginDedupCycle();
+
+  // Feed 1 goes away: its story is new again, feed 2's is still known
+  removeFeedFingerprints(1);
+  CHECK(check("Harbour bridge closed for repairs", 3) == DEDUP_NEW, "removed feed's story kept");
+  CHECK(check("Museum opens new dinosaur wing", 2) == DEDUP_SEEN, "other feed's story dropped");
+
+  // More removals than fit in the queue fall back to forgetting everything
+  beginDedupCycle();
+  for (uint16_t id = 10; id < 10 + DEDUP_PENDING_REMOVALS + 1; id++) removeFeedFingerprints(id);
+  CHECK(check("Museum opens new dinosaur wing", 2) == DEDUP_NEW, "overflow did not reset");
+}
+
+} // namespace
+
+int main() {
+  checkDuplicates();
+  checkFirstSeen();
+  checkFeedRemoval();
+  return finishHostTest("dedup_test");
+}
@@ -0,0 +1,87 @@
+#ifndef FEED_SAMPLES_H
+#define FEED_SAMPLES_H
+
+#include <stdio.h>
+#include <string>
+
+// Synthetic feeds shaped like the ones the display fetches: short titles
+// and dates buried among descriptions, media groups and categories.
+
+inline std::string sampleTitle(int i) {
+  char title[96];
+  snprintf(title, sizeof(title), "Headline %d: council approves budget &amp; new bus routes", i);
+  return title;
+}
+
+// RSS 2.0 feed of about 'bytes' bytes
+inline std::string makeRssFeed(size_t bytes) {
+  std::string xml =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<rss version=\"2.0\" xmlns:media=\"http://search.yahoo.com/mrss/\" "
+    "xmlns:dc=\"http://purl.org/dc/elements/1.1/\">\n"
+    "<channel>\n"
+    "  <title>Sample News - Top Stories</title>\n"
+    "  <link>https://news.example.com/</link>\n"
+    "  <description>Latest headlines</description>\n"
+    "  <image><url>https://news.example.com/logo.png</url><title>Sample News</title></image>\n";
+  char item[2048];
+  for (int i = 0; xml.size() < bytes; i++) {
+    snprintf(item, sizeof(item),
+      "  <item>\n"
+      "    <title>%s</title>\n"
+      "    <link>https://news.example.com/story/%d</link>\n"
+      "    <guid isPermaLink=\"false\">story-%d</guid>\n"
+      "    <pubDate>Tue, 10 Jun 2003 %02d:%02d:00 +0530</pubDate>\n"
+      "    <dc:creator>Staff Reporter</dc:creator>\n"
+      "    <!-- story %d -->\n"
+      "    <description><![CDATA[<p>The council met on Tuesday and approved the budget "
+      "after a long debate. <a href=\"https://news.example.com/story/%d\">Read more</a>"
+      "</p><img src=\"https://img.example.com/%d.jpg\" width=\"640\" height=\"360\"/>]]>"
+      "</description>\n"
+      "    <category>City</category><category>Politics</category><category>Transport</category>\n"
+      "    <media:group>\n"
+      "      <media:content url=\"https://img.example.com/%d.jpg\" medium=\"image\" width=\"640\" height=\"360\"/>\n"
+      "      <media:thumbnail url=\"https://img.example.com/%d_t.jpg\" width=\"160\" height=\"90\"/>\n"
+      "      <media:credit role=\"photographer\">Photo Desk</media:credit>\n"
+      "    </media:group>\n"
+      "  </item>\n",
+      sampleTitle(i).c_str(), i, i, i % 24, i % 60, i, i, i, i, i);
+    xml += item;
+  }
+  xml += "</channel>\n</rss>\n";
+  return xml;
+}
+
+// Atom feed of about 'bytes' bytes
+inline std::string makeAtomFeed(size_t bytes) {
+  std::string xml =
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+    "<feed xmlns=\"http://www.w3.org/2005/Atom\">\n"
+    "  <title>Sample Atom News</title>\n"
+    "  <link href=\"https://atom.example.com/\"/>\n"
+    "  <updated>2003-06-10T04:00:00Z</updated>\n"
+    "  <id>urn:example:feed</id>\n";
+  char entry[2048];
+  for (int i = 0; xml.size() < bytes; i++) {
+    snprintf(entry, sizeof(entry),
+      "  <entry>\n"
+      "    <title type=\"html\">%s</title>\n"
+      "    <link rel=\"alternate\" type=\"text/html\" href=\"https://atom.example.com/%d\"/>\n"
+      "    <id>urn:example:entry:%d</id>\n"
+      "    <published>2003-06-10T%02d:%02d:00+05:30</published>\n"
+      "    <updated>2003-06-10T%02d:%02d:00+05:30</updated>\n"
+      "    <author><name>Staff Reporter</name><email>desk@example.com</email></author>\n"
+      "    <category term=\"city\"/><category term=\"politics\"/>\n"
+      "    <summary type=\"html\">&lt;p&gt;The council met on Tuesday and approved the budget "
+      "after a long debate.&lt;/p&gt;</summary>\n"
+      "    <content type=\"html\"><![CDATA[<p>Full story text for entry %d, with a few "
+      "paragraphs of body copy that the display never shows.</p>]]></content>\n"
+      "  </entry>\n",
+      sampleTitle(i).c_str(), i, i, i % 24, i % 60, i % 24, i % 60, i);
+    xml += entry;
+  }
+  xml += "</feed>\n";
+  return xml;
+}
+
+#endif
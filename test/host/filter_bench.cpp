@@ -0,0 +1,122 @@
+// Matching checks and 1k / 10k rule benchmark for the keyword automaton
+
+#include "host_test.h"
+#include "rss_keywords.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+uint8_t match(const KeywordAutomaton* ac, const char* text) {
+  return matchKeywords(ac, text, strlen(text));
+}
+
+void checkMatching() {
+  KeywordAutomaton* ac = compileKeywords("cricket, stock market,elect*\nIPL", "monsoon,RBI");
+  CHECK(ac, "compile failed");
+  CHECK(keywordRules(ac) == 6, "rules %zu", keywordRules(ac));
+
+  CHECK(match(ac, "India win cricket series") == FILTER_BLOCK, "plain word");
+  CHECK(match(ac, "CRICKET: final today") == FILTER_BLOCK, "case and punctuation");
+  CHECK(match(ac, "Cricketers arrive") == FILTER_NONE, "whole word only");
+  CHECK(match(ac, "Stock   market rallies") == FILTER_BLOCK, "phrase with extra spaces");
+  CHECK(match(ac, "Stock-market rallies") == FILTER_BLOCK, "phrase across punctuation");
+  CHECK(match(ac, "Stockmarket rallies") == FILTER_NONE, "phrase needs a break");
+  CHECK(match(ac, "Election results due") == FILTER_BLOCK, "prefix");
+  CHECK(match(ac, "Reelected mayor") == FILTER_NONE, "prefix starts a word");
+  CHECK(match(ac, "ipl") == FILTER_BLOCK, "whole text");
+  CHECK(match(ac, "Monsoon reaches Kerala") == FILTER_BOOST, "boost");
+  CHECK(match(ac, "RBI comment on monsoon") == FILTER_BOOST, "two boosts");
+  CHECK(match(ac, "Monsoon delays IPL") == (FILTER_BLOCK | FILTER_BOOST), "both");
+  CHECK(match(ac, "") == FILTER_NONE, "empty title");
+  CHECK(matchKeywords(ac, "cricket", 3) == FILTER_NONE, "bounded length");
+  freeKeywords(ac);
+
+  CHECK(compileKeywords("", " , ,\n") == nullptr, "empty lists compile to nothing");
+  CHECK(compileKeywords(nullptr, nullptr) == nullptr, "null lists");
+  CHECK(match(nullptr, "cricket") == FILTER_NONE, "no automaton");
+}
+
+// Deterministic pseudo-words so runs are comparable
+uint32_t nextRandom(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+std::string makeRules(size_t count, std::vector<std::string>& words) {
+  static const char* const syllables[] = {
+    "ka", "ri", "to", "ne", "sha", "mu", "lo", "pe", "dra", "vi",
+    "gan", "tor", "bel", "zu", "qui", "mar", "sen", "fo", "ly", "chi"
+  };
+  uint32_t seed = 12345;
+  std::string list;
+  for (size_t i = 0; i < count; i++) {
+    std::string word;
+    int parts = 2 + nextRandom(seed) % 3;
+    for (int p = 0; p < parts; p++) word += syllables[nextRandom(seed) % 20];
+    if (i % 10 == 0) word += '*';
+    words.push_back(word);
+    if (!list.empty()) list += ',';
+    list += word;
+  }
+  return list;
+}
+
+const char* const titles[] = {
+  "Sensex ends 300 points higher as banking stocks rally in late trade",
+  "Monsoon to reach Kerala by June 4, says weather department",
+  "Government announces new scheme for rural housing in five states",
+  "Heavy rain disrupts traffic across the city; schools closed on Monday",
+  "Scientists discover new species of frog in the Western Ghats",
+  "Election commission releases schedule for assembly polls",
+  "Rupee slips 12 paise against the dollar in early trade",
+  "Local team wins state football championship after penalty shootout",
+};
+
+// The approach the automaton replaced: one case-insensitive search per rule
+uint8_t naiveMatch(const std::vector<std::string>& rules, const char* title) {
+  for (const std::string& rule : rules) {
+    if (strcasestr(title, rule.c_str())) return FILTER_BLOCK;
+  }
+  return FILTER_NONE;
+}
+
+void benchmark(size_t ruleCount) {
+  std::vector<std::string> words;
+  std::string list = makeRules(ruleCount, words);
+
+  KeywordAutomaton* ac = nullptr;
+  double compileNs = benchNs(1, [&] { ac = compileKeywords(list.c_str(), "monsoon"); });
+
+  const size_t titleCount = sizeof(titles) / sizeof(titles[0]);
+  size_t i = 0;
+  double matchNs = benchNs(100000, [&] {
+    const char* title = titles[i++ % titleCount];
+    benchSink += matchKeywords(ac, title, strlen(title));
+  });
+
+  i = 0;
+  double naiveNs = benchNs(ruleCount >= 10000 ? 200 : 2000, [&] {
+    benchSink += naiveMatch(words, titles[i++ % titleCount]);
+  });
+
+  printf("  %5zu rules: %6zu states, compile %7.2f ms, match %6.0f ns/title, "
+         "per-rule search %9.0f ns/title\n",
+         keywordRules(ac), keywordStates(ac), compileNs / 1e6, matchNs, naiveNs);
+
+  CHECK(keywordRules(ac) == ruleCount + 1, "rules %zu", keywordRules(ac));
+  CHECK(match(ac, titles[1]) == FILTER_BOOST, "boost lost among %zu rules", ruleCount);
+  std::string hit = "Breaking: " + words[3] + " announced";
+  CHECK(match(ac, hit.c_str()) & FILTER_BLOCK, "rule %s missed", words[3].c_str());
+  freeKeywords(ac);
+}
+
+} // namespace
+
+int main() {
+  checkMatching();
+  benchmark(1000);
+  benchmark(10000);
+  return finishHostTest("filter_bench");
+}
@@ -0,0 +1,39 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <chrono>
+#include <stdio.h>
+#include <stddef.h>
+
+// Minimal check and timing helpers shared by the host suites. Each suite
+// is its own executable and exits non-zero when any CHECK failed.
+
+inline int hostFailures = 0;
+
+#define CHECK(cond, ...) do { \
+    if (!(cond)) { \
+      printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+      printf(__VA_ARGS__); \
+      printf("\n"); \
+      hostFailures++; \
+    } \
+  } while (0)
+
+// Keeps results alive so the optimizer can't drop the timed work
+inline volatile size_t benchSink = 0;
+
+// Calls fn() 'iterations' times and returns nanoseconds per call
+template <typename Fn>
+double benchNs(size_t iterations, Fn fn) {
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; i++) fn();
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+inline int finishHostTest(const char* name) {
+  printf("%s: %s\n", name, hostFailures ? "FAILED" : "ok");
+  return hostFailures ? 1 : 0;
+}
+
+#endif
@@ -0,0 +1,122 @@
+// Full vs path-filtered tinyxml2 parse of 50 KB feeds: time and pool usage
+
+#include "host_test.h"
+#include "feed_samples.h"
+#include "tinyxml2.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+using namespace tinyxml2;
+
+namespace {
+
+// Same paths as feedPaths in rss_handler.cpp
+const char* const feedPaths[] = {
+  "rss/channel/item/title", "rss/channel/item/pubDate", "rss/channel/item/date",
+  "rss/channel/item/guid", "rss/channel/item/link",
+  "feed/entry/title", "feed/entry/published", "feed/entry/updated",
+  "feed/entry/id", "feed/entry/link"
+};
+
+const size_t FEED_BYTES = 50 * 1024;
+
+struct ParseResult {
+  double us;
+  size_t elements, attributes, texts, comments, arena;
+  std::vector<std::string> titles;
+};
+
+// Parses in place like the firmware, on a fresh copy each round
+ParseResult runParse(const std::string& xml, bool filtered, const char* itemName) {
+  XMLDocument doc;
+  doc.SetRetainMemory(true);
+  if (filtered) doc.SetPathFilter(feedPaths, sizeof(feedPaths) / sizeof(feedPaths[0]));
+
+  std::vector<char> buffer(xml.size() + 1);
+  const size_t rounds = 200;
+  bool ok = true;
+  // The copy is timed first: the document points into the buffer afterwards
+  double copyNs = benchNs(rounds, [&] {
+    memcpy(buffer.data(), xml.data(), xml.size());
+    benchSink += buffer[xml.size() / 2];
+  });
+  double ns = benchNs(rounds, [&] {
+    memcpy(buffer.data(), xml.data(), xml.size());
+    ok &= doc.ParseInSitu(buffer.data(), xml.size()) == XML_SUCCESS;
+  });
+  CHECK(ok, "%s parse failed: %s", filtered ? "filtered" : "full", doc.ErrorStr());
+
+  ParseResult r;
+  r.us = (ns - copyNs) / 1000.0;
+  r.elements = doc.ElementPeak();
+  r.attributes = doc.AttributePeak();
+  r.texts = doc.TextPeak();
+  r.comments = doc.CommentPeak();
+  r.arena = doc.ArenaBytes();
+
+  XMLElement* container = doc.RootElement();
+  if (container && strcmp(container->Name(), "rss") == 0) container = container->FirstChildElement("channel");
+  for (XMLElement* item = container ? container->FirstChildElement(itemName) : nullptr; item;
+       item = item->NextSiblingElement(itemName)) {
+    XMLElement* title = item->FirstChildElement("title");
+    r.titles.push_back(title && title->GetText() ? title->GetText() : "");
+  }
+  return r;
+}
+
+void compare(const char* label, const std::string& xml, const char* itemName) {
+  ParseResult full = runParse(xml, false, itemName);
+  ParseResult filtered = runParse(xml, true, itemName);
+
+  printf("  %s, %zu bytes, %zu items\n", label, xml.size(), full.titles.size());
+  printf("    full:     %7.1f us  elements %5zu  attributes %5zu  texts %5zu  comments %4zu  arena %7zu B\n",
+         full.us, full.elements, full.attributes, full.texts, full.comments, full.arena);
+  printf("    filtered: %7.1f us  elements %5zu  attributes %5zu  texts %5zu  comments %4zu  arena %7zu B\n",
+         filtered.us, filtered.elements, filtered.attributes, filtered.texts, filtered.comments,
+         filtered.arena);
+
+  CHECK(!full.titles.empty(), "%s: no items", label);
+  CHECK(filtered.titles == full.titles, "%s: filtered titles differ from the full parse", label);
+  CHECK(filtered.elements < full.elements / 2, "%s: filter kept %zu of %zu elements", label,
+        filtered.elements, full.elements);
+  // The XML declaration shares the comment pool
+  CHECK(filtered.comments <= 1, "%s: comments kept", label);
+}
+
+// What the filter keeps and drops, on a small document
+void checkFilter() {
+  char xml[] =
+    "<rss><channel><title>Channel</title>"
+    "<item><title>One</title><description><p>skip <b>me</b></p></description>"
+    "<pubDate>Tue, 10 Jun 2003 04:00:00 GMT</pubDate><media:group><media:content url=\"x\"/></media:group></item>"
+    "<item><!-- c --><title>Two</title><category>x</category></item>"
+    "</channel></rss>";
+  XMLDocument doc;
+  doc.SetPathFilter(feedPaths, sizeof(feedPaths) / sizeof(feedPaths[0]));
+  CHECK(doc.ParseInSitu(xml, strlen(xml)) == XML_SUCCESS, "parse: %s", doc.ErrorStr());
+
+  XMLElement* channel = doc.FirstChildElement("rss")->FirstChildElement("channel");
+  CHECK(!channel->FirstChildElement("title"), "channel title kept");
+  XMLElement* item = channel->FirstChildElement("item");
+  CHECK(item && strcmp(item->FirstChildElement("title")->GetText(), "One") == 0, "first title");
+  CHECK(item->FirstChildElement("pubDate"), "pubDate dropped");
+  CHECK(!item->FirstChildElement("description"), "description kept");
+  CHECK(!item->FirstChildElement("media:group"), "media group kept");
+  item = item->NextSiblingElement("item");
+  CHECK(item && strcmp(item->FirstChildElement("title")->GetText(), "Two") == 0, "second title");
+  CHECK(!item->FirstChildElement("category"), "category kept");
+
+  // Skipped content must still be balanced
+  char broken[] = "<rss><channel><item><title>One</title><description><p>open</description></item></channel></rss>";
+  CHECK(doc.ParseInSitu(broken, strlen(broken)) != XML_SUCCESS, "unbalanced skipped content accepted");
+}
+
+} // namespace
+
+int main() {
+  checkFilter();
+  compare("RSS", makeRssFeed(FEED_BYTES), "item");
+  compare("Atom", makeAtomFeed(FEED_BYTES), "entry");
+  return finishHostTest("parse_bench");
+}
@@ -0,0 +1,147 @@
+// Round-trip checks and per-frame encode cost of the preview codec
+
+#include "host_test.h"
+#include "p10_preview_codec.h"
+#include <string.h>
+#include <vector>
+
+namespace {
+
+const uint8_t WIDTH = 64;   // DISPLAY_WIDTH x DISPLAY_HEIGHT
+const uint8_t HEIGHT = 32;
+
+// Applies one encoded frame to 'screen' the way the dashboard does;
+// false if the frame is malformed
+bool decodeFrame(const uint8_t* data, size_t len, uint16_t* screen, uint8_t width, uint8_t height) {
+  if (len < PREVIEW_HEADER_BYTES || data[0] != PREVIEW_MAGIC) return false;
+  if (data[2] != width || data[3] != height) return false;
+  size_t p = PREVIEW_HEADER_BYTES;
+  while (p < len) {
+    uint8_t y = data[p++];
+    if (y >= height) return false;
+    size_t x = 0;
+    while (x < width) {
+      if (p + 3 > len) return false;
+      uint8_t count = data[p];
+      uint16_t color = data[p + 1] | (data[p + 2] << 8);
+      p += 3;
+      if (count == 0 || x + count > width) return false;
+      for (uint8_t i = 0; i < count; i++) screen[y * width + x++] = color;
+    }
+  }
+  return true;
+}
+
+uint32_t nextRandom(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+// A wide strip of blocky "text" in two colors on black, like the marquee
+std::vector<uint16_t> makeStrip(size_t stripWidth) {
+  std::vector<uint16_t> strip(stripWidth * HEIGHT, 0);
+  uint32_t seed = 7;
+  for (size_t x = 0; x < stripWidth; x++) {
+    bool gap = (x % 6) == 5;
+    for (uint8_t y = 9; y < 23 && !gap; y++) {
+      if (nextRandom(seed) % 3 == 0) strip[y * stripWidth + x] = (y < 16) ? 0xFFE0 : 0x07FF;
+    }
+  }
+  return strip;
+}
+
+void frameAt(const std::vector<uint16_t>& strip, size_t stripWidth, size_t offset, uint16_t* frame) {
+  for (uint8_t y = 0; y < HEIGHT; y++) {
+    for (uint8_t x = 0; x < WIDTH; x++) {
+      frame[y * WIDTH + x] = strip[y * stripWidth + (x + offset) % stripWidth];
+    }
+  }
+}
+
+struct Encoder {
+  std::vector<uint16_t> sent = std::vector<uint16_t>(WIDTH * HEIGHT, 0);
+  std::vector<uint8_t> out = std::vector<uint8_t>(PREVIEW_MAX_FRAME_BYTES(WIDTH, HEIGHT));
+  uint16_t seq = 0;
+
+  size_t encode(const uint16_t* frame, bool keyframe) {
+    return encodePreviewFrame(frame, sent.data(), WIDTH, HEIGHT, keyframe, seq++, out.data(), out.size());
+  }
+};
+
+void checkRoundTrip() {
+  const size_t stripWidth = 300;
+  std::vector<uint16_t> strip = makeStrip(stripWidth);
+  std::vector<uint16_t> frame(WIDTH * HEIGHT);
+  std::vector<uint16_t> screen(WIDTH * HEIGHT, 0x1234);
+  Encoder enc;
+
+  frameAt(strip, stripWidth, 0, frame.data());
+  size_t len = enc.encode(frame.data(), true);
+  CHECK(len > PREVIEW_HEADER_BYTES && enc.out[1] == PREVIEW_FLAG_KEYFRAME, "keyframe");
+  CHECK(decodeFrame(enc.out.data(), len, screen.data(), WIDTH, HEIGHT), "keyframe malformed");
+  CHECK(screen == frame, "keyframe does not reproduce the frame");
+  CHECK(enc.sent == frame, "sent copy not updated");
+
+  CHECK(enc.encode(frame.data(), false) == 0, "unchanged frame was encoded");
+
+  for (size_t t = 1; t < 40; t++) {
+    frameAt(strip, stripWidth, t, frame.data());
+    len = enc.encode(frame.data(), false);
+    CHECK(len > 0 && enc.out[1] == 0, "diff frame %zu", t);
+    CHECK(decodeFrame(enc.out.data(), len, screen.data(), WIDTH, HEIGHT), "diff %zu malformed", t);
+    CHECK(screen == frame, "diff %zu does not reproduce the frame", t);
+  }
+
+  // One pixel: one row in the diff, and its blank rows stay out of it
+  frame[5 * WIDTH + 10] ^= 0xFFFF;
+  len = enc.encode(frame.data(), false);
+  CHECK(len == PREVIEW_HEADER_BYTES + 1 + 3 * 3, "single pixel diff is %zu bytes", len);
+  CHECK(enc.out[PREVIEW_HEADER_BYTES] == 5, "wrong row");
+
+  // Worst case fills the buffer exactly; one byte less is refused
+  uint32_t seed = 1;
+  for (auto& px : frame) px = nextRandom(seed) | 1;
+  for (size_t x = 1; x < frame.size(); x += 2) frame[x] = frame[x - 1] ^ 0x8000;
+  Encoder worst;
+  len = encodePreviewFrame(frame.data(), worst.sent.data(), WIDTH, HEIGHT, true, 0,
+                           worst.out.data(), worst.out.size() - 1);
+  CHECK(len == 0, "overflowing frame accepted");
+  len = worst.encode(frame.data(), true);
+  CHECK(len == worst.out.size(), "worst case is %zu of %zu bytes", len, worst.out.size());
+}
+
+void benchmark() {
+  const size_t stripWidth = 1024;
+  std::vector<uint16_t> strip = makeStrip(stripWidth);
+  std::vector<std::vector<uint16_t>> frames(stripWidth, std::vector<uint16_t>(WIDTH * HEIGHT));
+  for (size_t t = 0; t < stripWidth; t++) frameAt(strip, stripWidth, t, frames[t].data());
+
+  Encoder enc;
+  size_t t = 0, bytes = 0;
+  double scrollNs = benchNs(50000, [&] {
+    bytes += enc.encode(frames[t++ % stripWidth].data(), false);
+  });
+  double scrollBytes = double(bytes) / 50000;
+
+  bytes = 0;
+  double keyNs = benchNs(50000, [&] {
+    bytes += enc.encode(frames[t++ % stripWidth].data(), true);
+  });
+  double keyBytes = double(bytes) / 50000;
+
+  double idleNs = benchNs(50000, [&] {
+    benchSink += enc.encode(frames[t % stripWidth].data(), false);
+  });
+
+  printf("  %ux%u: scrolling diff %6.0f ns/frame (%4.0f B), keyframe %6.0f ns/frame (%4.0f B), "
+         "unchanged %5.0f ns/frame\n",
+         WIDTH, HEIGHT, scrollNs, scrollBytes, keyNs, keyBytes, idleNs);
+}
+
+} // namespace
+
+int main() {
+  checkRoundTrip();
+  benchmark();
+  return finishHostTest("preview_bench");
+}
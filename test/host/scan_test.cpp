@@ -0,0 +1,211 @@
+// Broken-feed corpus and benchmark for the fallback scanner
+
+#include "host_test.h"
+#include "feed_samples.h"
+#include "rss_scan.h"
+#include "tinyxml2.h"
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Same paths as feedPaths in rss_handler.cpp
+const char* const feedPaths[] = {
+  "rss/channel/item/title", "rss/channel/item/pubDate", "rss/channel/item/date",
+  "rss/channel/item/guid", "rss/channel/item/link",
+  "feed/entry/title", "feed/entry/published", "feed/entry/updated",
+  "feed/entry/id", "feed/entry/link"
+};
+
+struct ScanCase {
+  const char* name;
+  const char* xml;
+  // Expected items as "title|date|link" lines, decoded title first
+  const char* expected;
+};
+
+// Breakage seen in real feeds. Each one is also scanned again after a
+// failed in-situ parse, which leaves NULs behind in the payload.
+const ScanCase corpus[] = {
+  {"unescaped ampersand",
+   "<rss><channel><title>Channel</title>"
+   "<item><title>Tom & Jerry return</title><pubDate>Tue, 10 Jun 2003 04:00:00 GMT</pubDate>"
+   "<link>https://e.com/1</link></item>"
+   "<item><title>Q&A: rates</title><guid>g2</guid></item>"
+   "</channel></rss>",
+   "Tom & Jerry return|Tue, 10 Jun 2003 04:00:00 GMT|https://e.com/1\n"
+   "Q&A: rates||g2\n"},
+
+  {"missing item end tags",
+   "<rss><channel><title>Channel</title>"
+   "<item><title>First</title><link>https://e.com/1</link>"
+   "<item><title>Second</title><link>https://e.com/2</link>"
+   "</channel></rss>",
+   "First||https://e.com/1\n"
+   "Second||https://e.com/2\n"},
+
+  {"unclosed title tag",
+   "<rss><channel><item><title>Broken tag<link>https://e.com/1</link></item>"
+   "<item><title>Fine</title></item></channel></rss>",
+   "Broken tag||https://e.com/1\n"
+   "Fine||\n"},
+
+  {"truncated payload",
+   "<rss><channel><title>Channel</title>"
+   "<item><title>Complete</title><pubDate>Tue, 10 Jun 2003 04:00:00 GMT</pubDate></item>"
+   "<item><title>Cut short</title><description>The story went on and o",
+   "Complete|Tue, 10 Jun 2003 04:00:00 GMT|\n"
+   "Cut short||\n"},
+
+  {"truncated inside a title",
+   "<rss><channel><item><title>Complete</title></item><item><title>Half a headl",
+   "Complete||\n"
+   "Half a headl||\n"},
+
+  {"CDATA and html titles",
+   "<rss><channel>"
+   "<item><title><![CDATA[Budget <b>&</b> more]]></title></item>"
+   "<item><title type=\"html\">Rates &amp; bonds &#8212; update</title></item>"
+   "<item><title>  Lots\n\t of   space  </title></item>"
+   "<item><title>Caf&#xE9; &lsquo;quotes&rsquo; &bogus; &#;</title></item>"
+   "</channel></rss>",
+   "Budget <b>&</b> more||\n"
+   "Rates & bonds \xE2\x80\x94 update||\n"
+   "Lots of space||\n"
+   "Caf\xC3\xA9 \xE2\x80\x98quotes\xE2\x80\x99 &bogus; &#;||\n"},
+
+  {"channel title and items without titles",
+   "<rss><channel><title>Channel only</title><image><title>Logo</title></image>"
+   "<item><description>No title here</description></item>"
+   "<item><title>   </title></item>"
+   "<item><title>Real</title></item>"
+   "</channel></rss>",
+   "Real||\n"},
+
+  {"comments, CDATA and declarations hide tags",
+   "<?xml version=\"1.0\"?><!DOCTYPE rss><rss><channel>"
+   "<!-- <item><title>Commented out</title></item> -->"
+   "<item><title>Visible</title><description><![CDATA[<item><title>Inside CDATA</title>]]>"
+   "</description></item>"
+   "</channel></rss>",
+   "Visible||\n"},
+
+  {"atom with links, ids and namespaces",
+   "<feed xmlns=\"http://www.w3.org/2005/Atom\"><title>Feed</title>"
+   "<entry><title type=\"text\">Atom one</title>"
+   "<link rel=\"alternate\" href=\"https://a.com/1\"/><id>urn:1</id>"
+   "<updated>2003-06-10T04:00:00Z</updated></entry>"
+   "<entry><title>Atom two</title><id>urn:2</id><dc:date>2003-06-11T04:00:00Z</dc:date>"
+   "<media:title>Not this</media:title></entry>"
+   "<entry><title>Atom <three</title><link href='https://a.com/3'/></entry>"
+   "</feed>",
+   "Atom one|2003-06-10T04:00:00Z|urn:1\n"
+   "Atom two|2003-06-11T04:00:00Z|urn:2\n"
+   "Atom <three||https://a.com/3\n"},
+
+  {"stray angle brackets and mismatched nesting",
+   "<rss><channel><item><title>3 < 5 and 7 > 2</title></item>"
+   "<item><title>Nested</title><b><i>bad</b></i></item></channel></rss>",
+   "3 < 5 and 7 > 2||\n"
+   "Nested||\n"},
+};
+
+struct Collected {
+  std::string lines;
+};
+
+bool collect(const FeedItem& item, void* context) {
+  Collected* out = static_cast<Collected*>(context);
+  out->lines += decodeFeedText(item.title, item.titleLen).c_str();
+  out->lines += '|';
+  if (item.date) out->lines.append(item.date, item.dateLen);
+  out->lines += '|';
+  if (item.link) out->lines.append(item.link, item.linkLen);
+  out->lines += '\n';
+  return true;
+}
+
+std::string scan(const char* data, size_t len) {
+  Collected out;
+  scanFeedItems(data, len, collect, &out);
+  return out.lines;
+}
+
+void checkCorpus() {
+  tinyxml2::XMLDocument doc;
+  doc.SetPathFilter(feedPaths, sizeof(feedPaths) / sizeof(feedPaths[0]));
+  size_t failedParses = 0;
+
+  for (const auto& c : corpus) {
+    size_t len = strlen(c.xml);
+    std::string raw = scan(c.xml, len);
+    CHECK(raw == c.expected, "%s:\n got:\n%s want:\n%s", c.name, raw.c_str(), c.expected);
+
+    // As in handleFeedFetch(): scan the payload a failed parse left behind
+    std::vector<char> payload(c.xml, c.xml + len + 1);
+    if (doc.ParseInSitu(payload.data(), len) == tinyxml2::XML_SUCCESS) continue;
+    failedParses++;
+    std::string afterParse = scan(payload.data(), len);
+    CHECK(afterParse == c.expected, "%s after in-situ parse:\n got:\n%s want:\n%s", c.name,
+          afterParse.c_str(), c.expected);
+  }
+  CHECK(failedParses >= 6, "only %zu corpus feeds broke the parser", failedParses);
+
+  // The callback can stop the scan
+  size_t calls = 0;
+  auto stopAfterOne = [](const FeedItem&, void* context) {
+    ++*static_cast<size_t*>(context);
+    return false;
+  };
+  const char* twoItems = corpus[1].xml;
+  CHECK(scanFeedItems(twoItems, strlen(twoItems), stopAfterOne, &calls) == 1 && calls == 1,
+        "scan did not stop");
+  CHECK(scan("", 0).empty(), "empty payload");
+}
+
+// A 50 KB feed broken the usual ways: "&amp;" left unescaped and the
+// item end tags missing
+void benchmark() {
+  std::string xml = makeRssFeed(50 * 1024);
+  for (size_t at = 0; (at = xml.find("&amp;", at)) != std::string::npos; at += 2) {
+    xml.replace(at, 5, "& ");
+  }
+  for (size_t at = 0; (at = xml.find("</item>", at)) != std::string::npos;) {
+    xml.erase(at, 7);
+  }
+
+  tinyxml2::XMLDocument doc;
+  std::vector<char> payload(xml.begin(), xml.end());
+  payload.push_back('\0');
+  CHECK(doc.ParseInSitu(payload.data(), xml.size()) != tinyxml2::XML_SUCCESS,
+        "benchmark feed is not broken");
+
+  size_t items = 0;
+  auto count = [](const FeedItem&, void* context) {
+    ++*static_cast<size_t*>(context);
+    return true;
+  };
+  double scanNs = benchNs(500, [&] {
+    items = 0;
+    scanFeedItems(xml.data(), xml.size(), count, &items);
+    benchSink += items;
+  });
+
+  std::string title = sampleTitle(7);
+  double decodeNs = benchNs(100000, [&] {
+    benchSink += decodeFeedText(title.data(), title.size()).length();
+  });
+
+  printf("  broken RSS, %zu bytes, %zu items: scan %.1f us (%.0f MB/s), decode %.0f ns/title\n",
+         xml.size(), items, scanNs / 1000.0, xml.size() / (scanNs / 1000.0), decodeNs);
+  CHECK(items > 0, "no items in benchmark feed");
+}
+
+} // namespace
+
+int main() {
+  checkCorpus();
+  benchmark();
+  return finishHostTest("scan_test");
+}
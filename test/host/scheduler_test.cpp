@@ -0,0 +1,206 @@
+// Rotation and dwell decisions of the content scheduler on a virtual clock
+
+#include "host_test.h"
+#include "p10_scheduler.h"
+
+namespace {
+
+bool near(size_t count, size_t want) {
+  return count + 1 >= want && count <= want + 1;
+}
+
+void countPicks(WeightedRotation& rotation, const uint8_t* weights, size_t count,
+                size_t picks, size_t* counts) {
+  for (size_t i = 0; i < count; i++) counts[i] = 0;
+  for (size_t n = 0; n < picks; n++) {
+    int pick = rotation.pickNext(weights, count);
+    CHECK(pick >= 0 && (size_t)pick < count, "pick %d out of range", pick);
+    if (pick >= 0) counts[pick]++;
+  }
+}
+
+void checkRotation() {
+  WeightedRotation rotation;
+
+  // Smooth interleaving: 3/1/1 gives A B A C A, not A A A B C
+  const uint8_t weights311[] = {3, 1, 1};
+  const int expected[] = {0, 1, 0, 2, 0};
+  for (int i = 0; i < 5; i++) {
+    int pick = rotation.pickNext(weights311, 3);
+    CHECK(pick == expected[i], "pick %d was %d, want %d", i, pick, expected[i]);
+  }
+
+  // Exact proportions over whole periods (sum of weights)
+  const uint8_t weights[] = {5, 2, 0, 7, 1};
+  size_t counts[5];
+  rotation.reset();
+  countPicks(rotation, weights, 5, 15 * 100, counts);
+  CHECK(counts[0] == 500 && counts[1] == 200 && counts[3] == 700 && counts[4] == 100,
+        "counts %zu/%zu/%zu/%zu", counts[0], counts[1], counts[3], counts[4]);
+  CHECK(counts[2] == 0, "disabled item picked %zu times", counts[2]);
+
+  // No run longer than the heavy weight needs: 7 of 15 never comes 3 in a row
+  rotation.reset();
+  int last = -1, run = 0, longest = 0;
+  for (int n = 0; n < 150; n++) {
+    int pick = rotation.pickNext(weights, 5);
+    run = (pick == last) ? run + 1 : 1;
+    if (run > longest) longest = run;
+    last = pick;
+  }
+  CHECK(longest <= 2, "longest run %d", longest);
+
+  // Disabling an item mid-rotation: the rest share its slots, and it
+  // comes back without a stored debt or credit
+  uint8_t changing[] = {1, 1, 1};
+  rotation.reset();
+  countPicks(rotation, changing, 3, 7, counts);
+  changing[1] = 0;
+  countPicks(rotation, changing, 3, 100, counts);
+  // Credit left from before the change can move one slot
+  CHECK(counts[1] == 0 && near(counts[0], 50) && near(counts[2], 50), "while disabled %zu/%zu/%zu",
+        counts[0], counts[1], counts[2]);
+  changing[1] = 1;
+  countPicks(rotation, changing, 3, 300, counts);
+  CHECK(near(counts[0], 100) && near(counts[1], 100) && near(counts[2], 100), "re-enabled %zu/%zu/%zu",
+        counts[0], counts[1], counts[2]);
+
+  // Nothing to show
+  const uint8_t none[] = {0, 0, 0};
+  CHECK(rotation.pickNext(none, 3) == -1, "all disabled");
+  CHECK(rotation.pickNext(weights, 0) == -1, "empty list");
+
+  // A single item is always next
+  const uint8_t one[] = {4};
+  for (int n = 0; n < 5; n++) CHECK(rotation.pickNext(one, 1) == 0, "single item");
+
+  // Lists longer than the scheduler tracks are cut, not overrun
+  uint8_t many[SCHEDULER_MAX_ITEMS + 4];
+  for (auto& w : many) w = 1;
+  rotation.reset();
+  for (int n = 0; n < 100; n++) {
+    int pick = rotation.pickNext(many, sizeof(many));
+    CHECK(pick >= 0 && pick < SCHEDULER_MAX_ITEMS, "pick %d beyond the table", pick);
+  }
+}
+
+void checkDwell() {
+  const DwellPolicy text = {1, 3000, 120000, true};
+  DwellTracker dwell;
+  const uint32_t t0 = 10000;
+
+  // Scrolling text: switches on the first completed pass after the minimum
+  dwell.begin(text, t0, 2000);
+  CHECK(!dwell.onScrollComplete(t0 + 2000), "pass before the minimum ended it");
+  CHECK(dwell.onScrollComplete(t0 + 4000), "pass after the minimum did not end it");
+  CHECK(dwell.expectedEnd() == t0 + 4000, "expected end %u", dwell.expectedEnd() - t0);
+  CHECK(!dwell.due(t0 + 119999), "due before the maximum");
+  CHECK(dwell.due(t0 + 120000), "not due at the maximum");
+
+  // A pass that ends exactly at the minimum counts
+  dwell.begin(text, t0, 1500);
+  CHECK(dwell.onScrollComplete(t0 + 3000), "pass ending at the minimum");
+  CHECK(dwell.expectedEnd() == t0 + 3000, "expected end %u", dwell.expectedEnd() - t0);
+
+  // Slower than the maximum: cut mid-scroll, and the estimate says so
+  dwell.begin(text, t0, 200000);
+  CHECK(dwell.expectedEnd() == t0 + 120000, "expected end %u", dwell.expectedEnd() - t0);
+  CHECK(dwell.due(t0 + 120000), "long scroll not cut at the maximum");
+
+  // Fits without scrolling: nothing to wait for past the minimum
+  dwell.begin(text, t0, 0);
+  CHECK(!dwell.due(t0 + 2999), "static item due early");
+  CHECK(dwell.due(t0 + 3000), "static item not due at the minimum");
+  CHECK(dwell.expectedEnd() == t0 + 3000, "static expected end");
+
+  // No maximum: only a completed pass ends it
+  const DwellPolicy unbounded = {1, 3000, 0, true};
+  dwell.begin(unbounded, t0, 5000);
+  CHECK(!dwell.due(t0 + 100000000), "unbounded item came due");
+  CHECK(dwell.onScrollComplete(t0 + 5000), "unbounded item ignored its pass");
+
+  // Timed items ignore scrolling
+  const DwellPolicy clock = {1, 5000, 0, false};
+  dwell.begin(clock, t0, 2000);
+  CHECK(!dwell.onScrollComplete(t0 + 6000), "timed item advanced on a pass");
+  CHECK(!dwell.due(t0 + 4999), "timed item due early");
+  CHECK(dwell.due(t0 + 5000), "timed item not due");
+
+  // millis() wraps after ~49 days
+  const uint32_t nearWrap = 0xFFFFFFFFu - 1000;
+  dwell.begin(text, nearWrap, 2000);
+  CHECK(!dwell.onScrollComplete(nearWrap + 2000), "wrap: early pass");
+  CHECK(dwell.onScrollComplete(nearWrap + 4000), "wrap: pass after the minimum");
+  CHECK(!dwell.due(nearWrap + 119999) && dwell.due(nearWrap + 120000), "wrap: maximum");
+}
+
+void checkDwellRange() {
+  CHECK(dwellInRange(500, 0) && dwellInRange(600000, 600000) && dwellInRange(3000, 3000),
+        "accepted range");
+  CHECK(!dwellInRange(499, 0) && !dwellInRange(600001, 0), "minimum out of range accepted");
+  CHECK(!dwellInRange(5000, 4999) && !dwellInRange(5000, 600001), "maximum out of range accepted");
+
+  DwellPolicy policy = {1, 0, 100, true};
+  clampDwell(policy);
+  CHECK(policy.minDwellMs == 500 && policy.maxDwellMs == 500, "clamped %u/%u",
+        policy.minDwellMs, policy.maxDwellMs);
+  policy = {1, 4000000000u, 0, true};
+  clampDwell(policy);
+  CHECK(policy.minDwellMs == 600000 && policy.maxDwellMs == 0, "clamped %u/%u",
+        policy.minDwellMs, policy.maxDwellMs);
+  policy = {1, 3000, 700000, true};
+  clampDwell(policy);
+  CHECK(policy.minDwellMs == 3000 && policy.maxDwellMs == 600000, "clamped %u/%u",
+        policy.minDwellMs, policy.maxDwellMs);
+}
+
+// Drives both together like the display loop, on a virtual clock
+void checkRotationOverTime() {
+  const DwellPolicy policies[] = {
+    {2, 3000, 20000, true},   // headlines, 7 s per pass
+    {1, 5000, 0, false},      // clock
+    {1, 3000, 20000, true},   // message, 40 s per pass: always cut
+  };
+  const uint32_t scrollMs[] = {7000, 0, 40000};
+  const uint8_t weights[] = {2, 1, 1};
+
+  WeightedRotation rotation;
+  DwellTracker dwell;
+  uint32_t now = 0;
+  uint32_t onScreen[3] = {};
+  size_t shown[3] = {};
+
+  for (int slot = 0; slot < 400; slot++) {
+    int item = rotation.pickNext(weights, 3);
+    dwell.begin(policies[item], now, scrollMs[item]);
+    uint32_t start = now;
+    uint32_t nextPass = scrollMs[item] ? now + scrollMs[item] : 0;
+    for (;; now += 10) {
+      if (nextPass && now >= nextPass) {
+        if (dwell.onScrollComplete(now)) break;
+        nextPass += scrollMs[item];
+      }
+      if (dwell.due(now)) break;
+    }
+    CHECK(now - start == dwell.expectedEnd() - start, "item %d ran %u ms, expected %u", item,
+          now - start, dwell.expectedEnd() - start);
+    onScreen[item] += now - start;
+    shown[item]++;
+  }
+
+  CHECK(shown[0] == 200 && shown[1] == 100 && shown[2] == 100, "slots %zu/%zu/%zu",
+        shown[0], shown[1], shown[2]);
+  CHECK(onScreen[0] == 200 * 7000u, "headlines %u ms", onScreen[0]);
+  CHECK(onScreen[1] == 100 * 5000u, "clock %u ms", onScreen[1]);
+  CHECK(onScreen[2] == 100 * 20000u, "message %u ms", onScreen[2]);
+}
+
+} // namespace
+
+int main() {
+  checkRotation();
+  checkDwell();
+  checkDwellRange();
+  checkRotationOverTime();
+  return finishHostTest("scheduler_test");
+}
@@ -0,0 +1,33 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+
+// Just enough of the Arduino core for the modules built on the host
+
+class String {
+public:
+  String() {}
+  String(const char* s) : _s(s ? s : "") {}
+
+  void reserve(size_t n) { _s.reserve(n); }
+  size_t length() const { return _s.size(); }
+  const char* c_str() const { return _s.c_str(); }
+  char operator[](size_t i) const { return _s[i]; }
+
+  String& operator+=(char c) { _s += c; return *this; }
+  String& operator+=(const char* s) { _s += s; return *this; }
+  String& operator+=(const String& s) { _s += s._s; return *this; }
+
+  bool operator==(const char* s) const { return _s == s; }
+  bool operator==(const String& s) const { return _s == s._s; }
+  bool operator!=(const char* s) const { return _s != s; }
+
+private:
+  std::string _s;
+};
+
+#endif
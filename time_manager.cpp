@@ -1,5 +1,13 @@
 
 #include "time_manager.h"
+#include <esp_sntp.h>
+
+static volatile bool ntpSynced = false;
+
+// Called from the SNTP client once it has set the clock
+static void onTimeSynced(struct timeval* tv) {
+  ntpSynced = true;
+}
 
 void initializeTime() {
   Serial.println("Initializing time system...");
@@ -7,11 +15,9 @@ void initializeTime() {
   // Apply timezone first
   applyTimezone();
   
-  if (hasInternet) {
-    syncTimeFromNTP();
-  } else {
-    syncTimeFromRTC();
-  }
+  // The RTC gives the panel a clock right away; NTP corrects it once
+  // the network startup task has internet
+  syncTimeFromRTC();
   
   Serial.printf("Current time: %s\n", getCurrentTimeString().c_str());
 }
@@ -31,31 +37,30 @@ void applyTimezone() {
   tzset();
 }
 
-void syncTimeFromNTP() {
+void beginNTPSync() {
   Serial.println("Syncing time from NTP...");
-  
+  ntpSynced = false;
+  sntp_set_time_sync_notification_cb(onTimeSynced);
   configTime(0, 0, "pool.ntp.org", "time.nist.gov", "time.cloudflare.com");
-  
-  int attempts = 0;
-  while (time(nullptr) < 100000 && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
-  }
+}
+
+bool ntpSyncDone() {
+  if (!ntpSynced) return false;
+  ntpSynced = false;
   
   time_t now = time(nullptr);
-  if (now > 100000) {
-    Serial.printf("\nNTP sync successful: %s", ctime(&now));
-    
-    // Update RTC if available
-    if (rtc.begin()) {
-      rtc.adjust(DateTime(now));
-      Serial.println("RTC updated from NTP");
-    }
-  } else {
-    Serial.println("\nNTP sync failed, trying RTC...");
-    syncTimeFromRTC();
+  Serial.printf("NTP sync successful: %s", ctime(&now));
+  
+  // Update RTC if available
+  if (rtc.begin()) {
+    rtc.adjust(DateTime(now));
+    Serial.println("RTC updated from NTP");
   }
+  return true;
+}
+
+bool clockIsSet() {
+  return time(nullptr) > 100000;
 }
 
 void syncTimeFromRTC() {
@@ -5,9 +5,11 @@
 #include "config.h"
 
 // Function declarations
-void initializeTime();
+void initializeTime();  // timezone and RTC only
 void applyTimezone();
-void syncTimeFromNTP();
+void beginNTPSync();    // returns at once; the SNTP client keeps retrying
+bool ntpSyncDone();     // true once, when NTP has set the clock (and the RTC)
+bool clockIsSet();      // from either source
 void syncTimeFromRTC();
 String getCurrentTimeString();
 String getCurrentDateString();
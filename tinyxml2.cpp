@@ -133,6 +133,27 @@ static const unsigned char TIXML_UTF_LEAD_2 = 0xbfU;
 namespace tinyxml2
 {
 
+static BlockAllocFn blockAlloc = malloc;
+static BlockFreeFn blockFree = free;
+
+void SetBlockAllocator( BlockAllocFn allocFn, BlockFreeFn freeFn )
+{
+    blockAlloc = allocFn ? allocFn : malloc;
+    blockFree = freeFn ? freeFn : free;
+}
+
+void* AllocBlock( size_t size )
+{
+    return blockAlloc( size );
+}
+
+void FreeBlock( void* mem )
+{
+    if ( mem ) {
+        blockFree( mem );
+    }
+}
+
 struct Entity {
     const char* pattern;
     int length;
@@ -727,27 +748,28 @@ char* XMLDocument::Identify( char* p, XMLNode** node, bool first )
 
     TIXMLASSERT( sizeof( XMLComment ) == sizeof( XMLUnknown ) );		// use same memory pool
     TIXMLASSERT( sizeof( XMLComment ) == sizeof( XMLDeclaration ) );	// use same memory pool
+    // The node's line is set once it exists: a pool can run out of memory,
+    // and then no node is returned and the document holds the error.
     XMLNode* returnNode = 0;
+    int nodeLine = _parseCurLineNum;	// first non-whitespace character
     if ( XMLUtil::StringEqual( p, xmlHeader, xmlHeaderLen ) ) {
         returnNode = CreateUnlinkedNode<XMLDeclaration>( _commentPool );
-        returnNode->_parseLineNum = _parseCurLineNum;
         p += xmlHeaderLen;
     }
     else if ( XMLUtil::StringEqual( p, commentHeader, commentHeaderLen ) ) {
         returnNode = CreateUnlinkedNode<XMLComment>( _commentPool );
-        returnNode->_parseLineNum = _parseCurLineNum;
         p += commentHeaderLen;
     }
     else if ( XMLUtil::StringEqual( p, cdataHeader, cdataHeaderLen ) ) {
         XMLText* text = CreateUnlinkedNode<XMLText>( _textPool );
         returnNode = text;
-        returnNode->_parseLineNum = _parseCurLineNum;
         p += cdataHeaderLen;
-        text->SetCData( true );
+        if ( text ) {
+            text->SetCData( true );
+        }
     }
     else if ( XMLUtil::StringEqual( p, dtdHeader, dtdHeaderLen ) ) {
         returnNode = CreateUnlinkedNode<XMLUnknown>( _commentPool );
-        returnNode->_parseLineNum = _parseCurLineNum;
         p += dtdHeaderLen;
     }
     else if ( XMLUtil::StringEqual( p, elementHeader, elementHeaderLen ) ) {
@@ -755,24 +777,24 @@ char* XMLDocument::Identify( char* p, XMLNode** node, bool first )
         // Preserve whitespace pedantically before closing tag, when it's immediately after opening tag
         if (WhitespaceMode() == PEDANTIC_WHITESPACE && first && p != start && *(p + elementHeaderLen) == '/') {
             returnNode = CreateUnlinkedNode<XMLText>(_textPool);
-            returnNode->_parseLineNum = startLine;
+            nodeLine = startLine;
             p = start;	// Back it up, all the text counts.
             _parseCurLineNum = startLine;
         }
         else {
             returnNode = CreateUnlinkedNode<XMLElement>(_elementPool);
-            returnNode->_parseLineNum = _parseCurLineNum;
             p += elementHeaderLen;
         }
     }
     else {
         returnNode = CreateUnlinkedNode<XMLText>( _textPool );
-        returnNode->_parseLineNum = _parseCurLineNum; // Report line of first non-whitespace character
         p = start;	// Back it up, all the text counts.
         _parseCurLineNum = startLine;
     }
 
-    TIXMLASSERT( returnNode );
+    if ( returnNode ) {
+        returnNode->_parseLineNum = nodeLine;
+    }
     TIXMLASSERT( p );
     *node = returnNode;
     return p;
@@ -869,7 +891,7 @@ XMLNode* XMLNode::DeepClone(XMLDocument* target) const
 
 	for (const XMLNode* child = this->FirstChild(); child; child = child->NextSibling()) {
 		XMLNode* childClone = child->DeepClone(target);
-		TIXMLASSERT(childClone);
+		if (!childClone) return clone;	// out of memory; 'target' has the error
 		clone->InsertEndChild(childClone);
 	}
 	return clone;
@@ -1092,10 +1114,24 @@ char* XMLNode::ParseDeep( char* p, StrPair* parentEndTag, int* curLineNumPtr )
 	if (_document->Error())
 		return 0;
 
+	// Path filter state of this element; its children get their own
+	const int containerState = _document->_pathState;
+
 	bool first = true;
 	while( p && *p ) {
         XMLNode* node = 0;
 
+        int childState = XMLDocument::PATH_KEEP_ALL;
+        if ( containerState != XMLDocument::PATH_KEEP_ALL ) {
+            p = _document->SkipFiltered( p, containerState, &childState );
+            if ( !p ) {
+                break;
+            }
+            if ( !*p ) {
+                break;
+            }
+        }
+
         p = _document->Identify( p, &node, first );
         TIXMLASSERT( p );
         if ( node == 0 ) {
@@ -1106,7 +1142,9 @@ char* XMLNode::ParseDeep( char* p, StrPair* parentEndTag, int* curLineNumPtr )
        const int initialLineNum = node->_parseLineNum;
 
         StrPair endTag;
+        _document->_pathState = childState;
         p = node->ParseDeep( p, &endTag, curLineNumPtr );
+        _document->_pathState = containerState;
         if ( !p ) {
             _document->DeleteNode( node );
             if ( !_document->Error() ) {
@@ -1263,7 +1301,9 @@ XMLNode* XMLText::ShallowClone( XMLDocument* doc ) const
         doc = _document;
     }
     XMLText* text = doc->NewText( Value() );	// fixme: this will always allocate memory. Intern?
-    text->SetCData( this->CData() );
+    if ( text ) {
+        text->SetCData( this->CData() );
+    }
     return text;
 }
 
@@ -1922,7 +1962,9 @@ XMLAttribute* XMLElement::FindOrCreateAttribute( const char* name )
     }
     if ( !attrib ) {
         attrib = CreateAttribute();
-        TIXMLASSERT( attrib );
+        if ( !attrib ) {
+            return 0;
+        }
         if ( last ) {
             TIXMLASSERT( last->_next == 0 );
             last->_next = attrib;
@@ -1971,7 +2013,9 @@ char* XMLElement::ParseAttributes( char* p, int* curLineNumPtr )
         // attribute.
         if (XMLUtil::IsNameStartChar( static_cast<unsigned char>(*p) ) ) {
             XMLAttribute* attrib = CreateAttribute();
-            TIXMLASSERT( attrib );
+            if ( !attrib ) {
+                return 0;
+            }
             attrib->_parseLineNum = _document->_parseCurLineNum;
 
             const int attrLineNum = attrib->_parseLineNum;
@@ -2028,8 +2072,12 @@ void XMLElement::DeleteAttribute( XMLAttribute* attribute )
 XMLAttribute* XMLElement::CreateAttribute()
 {
     TIXMLASSERT( sizeof( XMLAttribute ) == _document->_attributePool.ItemSize() );
-    XMLAttribute* attrib = new (_document->_attributePool.Alloc() ) XMLAttribute();
-    TIXMLASSERT( attrib );
+    void* mem = _document->_attributePool.Alloc();
+    if ( !mem ) {
+        _document->SetError( XML_ERROR_OUT_OF_MEMORY, _document->_parseCurLineNum, 0 );
+        return 0;
+    }
+    XMLAttribute* attrib = new (mem) XMLAttribute();
     attrib->_memPool = &_document->_attributePool;
     attrib->_memPool->SetTracked();
     return attrib;
@@ -2107,6 +2155,9 @@ XMLNode* XMLElement::ShallowClone( XMLDocument* doc ) const
         doc = _document;
     }
     XMLElement* element = doc->NewElement( Value() );					// fixme: this will always allocate memory. Intern?
+    if ( !element ) {
+        return 0;
+    }
     for( const XMLAttribute* a=FirstAttribute(); a; a=a->Next() ) {
         element->SetAttribute( a->Name(), a->Value() );					// fixme: this will always allocate memory. Intern?
     }
@@ -2176,7 +2227,8 @@ const char* XMLDocument::_errorNames[XML_ERROR_COUNT] = {
     "XML_ERROR_PARSING",
     "XML_CAN_NOT_CONVERT_TEXT",
     "XML_NO_TEXT_NODE",
-	"XML_ELEMENT_DEPTH_EXCEEDED"
+	"XML_ELEMENT_DEPTH_EXCEEDED",
+    "XML_ERROR_OUT_OF_MEMORY"
 };
 
 
@@ -2189,13 +2241,18 @@ XMLDocument::XMLDocument( bool processEntities, Whitespace whitespaceMode ) :
     _errorStr(),
     _errorLineNum( 0 ),
     _charBuffer( 0 ),
+    _charStore( 0 ),
+    _charStoreCapacity( 0 ),
+    _retainMemory( false ),
     _parseCurLineNum( 0 ),
 	_parsingDepth(0),
     _unlinked(),
     _elementPool(),
     _attributePool(),
     _textPool(),
-    _commentPool()
+    _commentPool(),
+    _pathFilter(),
+    _pathState( PATH_KEEP_ALL )
 {
     // avoid VC++ C4355 warning about 'this' in initializer list (C4355 is off by default in VS2012+)
     _document = this;
@@ -2205,6 +2262,7 @@ XMLDocument::XMLDocument( bool processEntities, Whitespace whitespaceMode ) :
 XMLDocument::~XMLDocument()
 {
     Clear();
+    ReleaseMemory();
 }
 
 
@@ -2233,8 +2291,12 @@ void XMLDocument::Clear()
 #endif
     ClearError();
 
-    delete [] _charBuffer;
     _charBuffer = 0;
+    if ( !_retainMemory ) {
+        FreeBlock( _charStore );
+        _charStore = 0;
+        _charStoreCapacity = 0;
+    }
 	_parsingDepth = 0;
 
 #if 0
@@ -2252,6 +2314,263 @@ void XMLDocument::Clear()
         TIXMLASSERT( _commentPool.CurrentAllocs()   == _commentPool.Untracked() );
     }
 #endif
+    ResetPools();
+}
+
+
+bool XMLDocument::Reserve( size_t chars, size_t elements, size_t attributes, size_t texts, size_t comments )
+{
+    if ( chars > _charStoreCapacity && !_charBuffer ) {
+        char* store = static_cast<char*>( AllocBlock( chars ) );
+        if ( !store ) {
+            return false;
+        }
+        FreeBlock( _charStore );
+        _charStore = store;
+        _charStoreCapacity = chars;
+    }
+    return _elementPool.Reserve( elements ) &&
+           _attributePool.Reserve( attributes ) &&
+           _textPool.Reserve( texts ) &&
+           _commentPool.Reserve( comments );
+}
+
+
+void XMLDocument::ReleaseMemory()
+{
+    // Nodes live in the pools, so the document goes first
+    Clear();
+    FreeBlock( _charStore );
+    _charStore = 0;
+    _charStoreCapacity = 0;
+    _elementPool.Clear();
+    _attributePool.Clear();
+    _textPool.Clear();
+    _commentPool.Clear();
+}
+
+
+size_t XMLDocument::ArenaBytes() const
+{
+    return _charStoreCapacity +
+           _elementPool.Capacity() * _elementPool.ItemSize() +
+           _attributePool.Capacity() * _attributePool.ItemSize() +
+           _textPool.Capacity() * _textPool.ItemSize() +
+           _commentPool.Capacity() * _commentPool.ItemSize();
+}
+
+
+void XMLDocument::SetPathFilter( const char* const* paths, size_t count )
+{
+    _pathFilter.Clear();
+    if ( !paths || count == 0 ) {
+        return;
+    }
+
+    PathFilterNode root = { 0, 0, -1, -1, false };
+    _pathFilter.Push( root );
+
+    for( size_t i = 0; i < count; ++i ) {
+        const char* segment = paths[i];
+        int node = 0;
+        while( segment && *segment ) {
+            const char* end = strchr( segment, '/' );
+            const size_t length = end ? static_cast<size_t>( end - segment ) : strlen( segment );
+
+            int child = _pathFilter[node].firstChild;
+            while( child >= 0 ) {
+                const PathFilterNode& c = _pathFilter[child];
+                if ( c.nameLength == length && strncmp( c.name, segment, length ) == 0 ) {
+                    break;
+                }
+                child = c.nextSibling;
+            }
+            if ( child < 0 ) {
+                PathFilterNode added = { segment, length, -1, _pathFilter[node].firstChild, false };
+                child = static_cast<int>( _pathFilter.Size() );
+                _pathFilter.Push( added );
+                _pathFilter[node].firstChild = child;
+            }
+            node = child;
+            segment = end ? end + 1 : 0;
+        }
+        _pathFilter[node].keepSubtree = true;
+    }
+}
+
+
+static int CountNewlines( const char* p, const char* end )
+{
+    int lines = 0;
+    for( ; p < end; ++p ) {
+        if ( *p == '\n' ) {
+            ++lines;
+        }
+    }
+    return lines;
+}
+
+
+// Called in a filtered element before each child. Skips comments,
+// unknown declarations and child elements that are not on a kept path,
+// and returns with 'p' at the next node to parse normally. For an
+// element start tag, 'childState' is the state its content parses with.
+char* XMLDocument::SkipFiltered( char* p, int containerState, int* childState )
+{
+    for( ;; ) {
+        p = XMLUtil::SkipWhiteSpace( p, &_parseCurLineNum );
+        if ( *p != '<' ) {
+            return p;	// text (or the end); parse it normally
+        }
+
+        if ( XMLUtil::StringEqual( p, "<!--", 4 ) ) {
+            char* end = strstr( p + 4, "-->" );
+            if ( !end ) {
+                SetError( XML_ERROR_PARSING_COMMENT, _parseCurLineNum, 0 );
+                return 0;
+            }
+            end += 3;
+            _parseCurLineNum += CountNewlines( p, end );
+            p = end;
+            continue;
+        }
+        if ( p[1] == '!' && !XMLUtil::StringEqual( p, "<![CDATA[", 9 ) ) {
+            char* end = strchr( p, '>' );
+            if ( !end ) {
+                SetError( XML_ERROR_PARSING_UNKNOWN, _parseCurLineNum, 0 );
+                return 0;
+            }
+            ++end;
+            _parseCurLineNum += CountNewlines( p, end );
+            p = end;
+            continue;
+        }
+        if ( !XMLUtil::IsNameStartChar( static_cast<unsigned char>( p[1] ) ) ) {
+            return p;	// end tag, CDATA or declaration
+        }
+
+        const char* name = p + 1;
+        const char* nameEnd = name;
+        while( XMLUtil::IsNameChar( static_cast<unsigned char>( *nameEnd ) ) ) {
+            ++nameEnd;
+        }
+        const size_t length = static_cast<size_t>( nameEnd - name );
+
+        for( int child = _pathFilter[containerState].firstChild; child >= 0; child = _pathFilter[child].nextSibling ) {
+            const PathFilterNode& c = _pathFilter[child];
+            const bool match = ( c.nameLength == 1 && c.name[0] == '*' ) ||
+                               ( c.nameLength == length && strncmp( c.name, name, length ) == 0 );
+            if ( match ) {
+                *childState = c.keepSubtree ? static_cast<int>( PATH_KEEP_ALL ) : child;
+                return p;
+            }
+        }
+
+        char* end = SkipElement( p );
+        if ( !end ) {
+            SetError( XML_ERROR_PARSING_ELEMENT, _parseCurLineNum, 0 );
+            return 0;
+        }
+        _parseCurLineNum += CountNewlines( p, end );
+        p = end;
+    }
+}
+
+
+// Skips an element and everything inside it, given 'p' at its '<'.
+// Returns the position just past its end, or 0 if it never closes.
+char* XMLDocument::SkipElement( char* p )
+{
+    int depth = 0;
+    for( ;; ) {
+        p = strchr( p, '<' );
+        if ( !p ) {
+            return 0;
+        }
+
+        const char* terminator = ">";
+        if ( XMLUtil::StringEqual( p, "<!--", 4 ) ) {
+            terminator = "-->";
+        }
+        else if ( XMLUtil::StringEqual( p, "<![CDATA[", 9 ) ) {
+            terminator = "]]>";
+        }
+        else if ( p[1] == '?' ) {
+            terminator = "?>";
+        }
+        else if ( p[1] == '!' || p[1] == '/' ) {
+            // declaration or end tag
+        }
+        else {
+            // Start tag: find its '>' outside attribute quotes
+            char quote = 0;
+            ++p;
+            while( *p && ( quote || *p != '>' ) ) {
+                if ( quote ) {
+                    if ( *p == quote ) {
+                        quote = 0;
+                    }
+                }
+                else if ( *p == '"' || *p == '\'' ) {
+                    quote = *p;
+                }
+                ++p;
+            }
+            if ( !*p ) {
+                return 0;
+            }
+            if ( *( p - 1 ) != '/' ) {
+                ++depth;
+            }
+            else if ( depth == 0 ) {
+                return p + 1;
+            }
+            ++p;
+            continue;
+        }
+
+        const bool endTag = p[1] == '/';
+        p = strstr( p + 1, terminator );
+        if ( !p ) {
+            return 0;
+        }
+        p += strlen( terminator );
+        if ( endTag && --depth == 0 ) {
+            return p;
+        }
+    }
+}
+
+
+// Returns null, keeping the old store, if a larger one can't be allocated
+char* XMLDocument::AcquireCharBuffer( size_t size )
+{
+    TIXMLASSERT( _charBuffer == 0 );
+    if ( size > _charStoreCapacity ) {
+        char* store = static_cast<char*>( AllocBlock( size ) );
+        if ( !store ) {
+            return 0;
+        }
+        FreeBlock( _charStore );
+        _charStore = store;
+        _charStoreCapacity = size;
+    }
+    _charBuffer = _charStore;
+    return _charBuffer;
+}
+
+
+void XMLDocument::ResetPools()
+{
+    // Every node is gone, so the pools can be rewound in place
+    _elementPool.Reset();
+    _attributePool.Reset();
+    _textPool.Reset();
+    _commentPool.Reset();
+    _elementPool.ResetPeak();
+    _attributePool.ResetPeak();
+    _textPool.ResetPeak();
+    _commentPool.ResetPeak();
 }
 
 
@@ -2264,14 +2583,18 @@ void XMLDocument::DeepCopy(XMLDocument* target) const
 
 	target->Clear();
 	for (const XMLNode* node = this->FirstChild(); node; node = node->NextSibling()) {
-		target->InsertEndChild(node->DeepClone(target));
+		XMLNode* clone = node->DeepClone(target);
+		if (!clone) return;
+		target->InsertEndChild(clone);
 	}
 }
 
 XMLElement* XMLDocument::NewElement( const char* name )
 {
     XMLElement* ele = CreateUnlinkedNode<XMLElement>( _elementPool );
-    ele->SetName( name );
+    if ( ele ) {
+        ele->SetName( name );
+    }
     return ele;
 }
 
@@ -2279,7 +2602,9 @@ XMLElement* XMLDocument::NewElement( const char* name )
 XMLComment* XMLDocument::NewComment( const char* str )
 {
     XMLComment* comment = CreateUnlinkedNode<XMLComment>( _commentPool );
-    comment->SetValue( str );
+    if ( comment ) {
+        comment->SetValue( str );
+    }
     return comment;
 }
 
@@ -2287,7 +2612,9 @@ XMLComment* XMLDocument::NewComment( const char* str )
 XMLText* XMLDocument::NewText( const char* str )
 {
     XMLText* text = CreateUnlinkedNode<XMLText>( _textPool );
-    text->SetValue( str );
+    if ( text ) {
+        text->SetValue( str );
+    }
     return text;
 }
 
@@ -2295,7 +2622,9 @@ XMLText* XMLDocument::NewText( const char* str )
 XMLDeclaration* XMLDocument::NewDeclaration( const char* str )
 {
     XMLDeclaration* dec = CreateUnlinkedNode<XMLDeclaration>( _commentPool );
-    dec->SetValue( str ? str : "xml version=\"1.0\" encoding=\"UTF-8\"" );
+    if ( dec ) {
+        dec->SetValue( str ? str : "xml version=\"1.0\" encoding=\"UTF-8\"" );
+    }
     return dec;
 }
 
@@ -2303,7 +2632,9 @@ XMLDeclaration* XMLDocument::NewDeclaration( const char* str )
 XMLUnknown* XMLDocument::NewUnknown( const char* str )
 {
     XMLUnknown* unk = CreateUnlinkedNode<XMLUnknown>( _commentPool );
-    unk->SetValue( str );
+    if ( unk ) {
+        unk->SetValue( str );
+    }
     return unk;
 }
 
@@ -2399,8 +2730,10 @@ XMLError XMLDocument::LoadFile( FILE* fp )
     }
 
     const size_t size = static_cast<size_t>(filelength);
-    TIXMLASSERT( _charBuffer == 0 );
-    _charBuffer = new char[size+1];
+    if ( !AcquireCharBuffer( size+1 ) ) {
+        SetError( XML_ERROR_OUT_OF_MEMORY, 0, 0 );
+        return _errorID;
+    }
     const size_t read = fread( _charBuffer, 1, size, fp );
     if ( read != size ) {
         SetError( XML_ERROR_FILE_READ_ERROR, 0, 0 );
@@ -2455,23 +2788,65 @@ XMLError XMLDocument::Parse( const char* xml, size_t nBytes )
     if ( nBytes == static_cast<size_t>(-1) ) {
         nBytes = strlen( xml );
     }
-    TIXMLASSERT( _charBuffer == 0 );
-    _charBuffer = new char[ nBytes+1 ];
+    if ( !AcquireCharBuffer( nBytes+1 ) ) {
+        SetError( XML_ERROR_OUT_OF_MEMORY, 0, 0 );
+        return _errorID;
+    }
     memcpy( _charBuffer, xml, nBytes );
     _charBuffer[nBytes] = 0;
 
     Parse();
     if ( Error() ) {
-        // clean up now essentially dangling memory.
-        // and the parse fail can put objects in the
-        // pools that are dead and inaccessible.
-        DeleteChildren();
+        DiscardFailedParse();
+    }
+    return _errorID;
+}
+
+
+XMLError XMLDocument::ParseInSitu( char* xml, size_t nBytes )
+{
+    Clear();
+
+    if ( nBytes == 0 || !xml || !*xml ) {
+        SetError( XML_ERROR_EMPTY_DOCUMENT, 0, 0 );
+        return _errorID;
+    }
+    if ( nBytes == static_cast<size_t>(-1) ) {
+        nBytes = strlen( xml );
+    }
+    // Not owned: Clear() only forgets it
+    _charBuffer = xml;
+    _charBuffer[nBytes] = 0;
+
+    Parse();
+    if ( Error() ) {
+        DiscardFailedParse();
+    }
+    return _errorID;
+}
+
+
+void XMLDocument::DiscardFailedParse()
+{
+    // clean up now essentially dangling memory.
+    // and the parse fail can put objects in the
+    // pools that are dead and inaccessible.
+    DeleteChildren();
+    while( _unlinked.Size()) {
+        DeleteNode(_unlinked[0]);
+    }
+    if ( _retainMemory ) {
+        _elementPool.Reset();
+        _attributePool.Reset();
+        _textPool.Reset();
+        _commentPool.Reset();
+    }
+    else {
         _elementPool.Clear();
         _attributePool.Clear();
         _textPool.Clear();
         _commentPool.Clear();
     }
-    return _errorID;
 }
 
 
@@ -2553,6 +2928,7 @@ void XMLDocument::Parse()
     TIXMLASSERT( _charBuffer );
     _parseCurLineNum = 1;
     _parseLineNum = 1;
+    _pathState = _pathFilter.Empty() ? static_cast<int>( PATH_KEEP_ALL ) : 0;
     char* p = _charBuffer;
     p = XMLUtil::SkipWhiteSpace( p, &_parseCurLineNum );
     p = const_cast<char*>( XMLUtil::ReadBOM( p, &_writeBOM ) );
@@ -3018,4 +3394,4 @@ bool XMLPrinter::Visit( const XMLUnknown& unknown )
     return true;
 }
 
-}   // namespace tinyxml2
\ No newline at end of file
+}   // namespace tinyxml2
\ No newline at end of file
@@ -318,6 +318,21 @@ private:
 };
 
 
+/*
+	Storage for pool blocks and document character buffers. Defaults to
+	malloc/free; an embedded application can route this bulk memory to a
+	dedicated region (external RAM, for example). The allocator may return
+	null: the pool or buffer is then left as it was, and a parse fails with
+	XML_ERROR_OUT_OF_MEMORY. Set it before any document allocates.
+*/
+typedef void* (*BlockAllocFn)( size_t size );
+typedef void (*BlockFreeFn)( void* mem );
+
+TINYXML2_LIB void SetBlockAllocator( BlockAllocFn allocFn, BlockFreeFn freeFn );
+TINYXML2_LIB void* AllocBlock( size_t size );
+TINYXML2_LIB void FreeBlock( void* mem );
+
+
 /*
 	Parent virtual class of a pool for fast allocation
 	and deallocation of objects.
@@ -351,7 +366,7 @@ public:
         // Delete the blocks.
         while( !_blockPtrs.Empty()) {
             Block* lastBlock = _blockPtrs.Pop();
-            delete lastBlock;
+            FreeBlock( lastBlock );
         }
         _root = 0;
         _currentAllocs = 0;
@@ -360,25 +375,57 @@ public:
         _nUntracked = 0;
     }
 
+    // Mark every item free again but keep the blocks for reuse. Only valid
+    // once no live object remains in the pool. The free list is rebuilt in
+    // address order, so a fresh document fills blocks front to back.
+    void Reset() {
+        _root = 0;
+        for( size_t b = _blockPtrs.Size(); b > 0; --b ) {
+            Item* blockItems = _blockPtrs[b - 1]->items;
+            for( size_t i = ITEMS_PER_BLOCK; i > 0; --i ) {
+                blockItems[i - 1].next = _root;
+                _root = &blockItems[i - 1];
+            }
+        }
+        _currentAllocs = 0;
+        _nUntracked = 0;
+    }
+
+    // Pre-allocate blocks so at least 'items' objects fit without growing.
+    // Returns false if the block allocator ran out first.
+    bool Reserve( size_t items ) {
+        while( _blockPtrs.Size() * ITEMS_PER_BLOCK < items ) {
+            if ( !AddBlock() ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     virtual size_t ItemSize() const override {
         return ITEM_SIZE;
     }
     size_t CurrentAllocs() const {
         return _currentAllocs;
     }
+    // Highest simultaneous allocation count since the last ResetPeak()
+    size_t PeakAllocs() const {
+        return _maxAllocs;
+    }
+    void ResetPeak() {
+        _maxAllocs = _currentAllocs;
+    }
+    size_t Capacity() const {
+        return _blockPtrs.Size() * ITEMS_PER_BLOCK;
+    }
 
+    // Returns null when a new block is needed and can't be allocated
     virtual void* Alloc() override{
         if ( !_root ) {
             // Need a new block.
-            Block* block = new Block;
-            _blockPtrs.Push( block );
-
-            Item* blockItems = block->items;
-            for( size_t i = 0; i < ITEMS_PER_BLOCK - 1; ++i ) {
-                blockItems[i].next = &(blockItems[i + 1]);
+            if ( !AddBlock() ) {
+                return 0;
             }
-            blockItems[ITEMS_PER_BLOCK - 1].next = 0;
-            _root = blockItems;
         }
         Item* const result = _root;
         TIXMLASSERT( result != 0 );
@@ -443,6 +490,23 @@ private:
     struct Block {
         Item items[ITEMS_PER_BLOCK];
     };
+
+    // Blocks are plain storage, so raw memory from the block allocator will do.
+    bool AddBlock() {
+        Block* block = static_cast<Block*>( AllocBlock( sizeof( Block ) ) );
+        if ( !block ) {
+            return false;
+        }
+        _blockPtrs.Push( block );
+
+        Item* blockItems = block->items;
+        for( size_t i = 0; i < ITEMS_PER_BLOCK - 1; ++i ) {
+            blockItems[i].next = &(blockItems[i + 1]);
+        }
+        blockItems[ITEMS_PER_BLOCK - 1].next = _root;
+        _root = blockItems;
+        return true;
+    }
     DynArray< Block*, 10 > _blockPtrs;
     Item* _root;
 
@@ -535,6 +599,7 @@ enum XMLError {
     XML_CAN_NOT_CONVERT_TEXT,
     XML_NO_TEXT_NODE,
 	XML_ELEMENT_DEPTH_EXCEEDED,
+    XML_ERROR_OUT_OF_MEMORY,
 
 	XML_ERROR_COUNT
 };
@@ -1465,45 +1530,61 @@ public:
 	/// Sets the named attribute to value.
     void SetAttribute( const char* name, const char* value )	{
         XMLAttribute* a = FindOrCreateAttribute( name );
-        a->SetAttribute( value );
+        if ( a ) {
+            a->SetAttribute( value );
+        }
     }
     /// Sets the named attribute to value.
     void SetAttribute( const char* name, int value )			{
         XMLAttribute* a = FindOrCreateAttribute( name );
-        a->SetAttribute( value );
+        if ( a ) {
+            a->SetAttribute( value );
+        }
     }
     /// Sets the named attribute to value.
     void SetAttribute( const char* name, unsigned value )		{
         XMLAttribute* a = FindOrCreateAttribute( name );
-        a->SetAttribute( value );
+        if ( a ) {
+            a->SetAttribute( value );
+        }
     }
 
 	/// Sets the named attribute to value.
 	void SetAttribute(const char* name, int64_t value) {
 		XMLAttribute* a = FindOrCreateAttribute(name);
-		a->SetAttribute(value);
+		if ( a ) {
+			a->SetAttribute(value);
+		}
 	}
 
     /// Sets the named attribute to value.
     void SetAttribute(const char* name, uint64_t value) {
         XMLAttribute* a = FindOrCreateAttribute(name);
-        a->SetAttribute(value);
+        if ( a ) {
+            a->SetAttribute(value);
+        }
     }
 
     /// Sets the named attribute to value.
     void SetAttribute( const char* name, bool value )			{
         XMLAttribute* a = FindOrCreateAttribute( name );
-        a->SetAttribute( value );
+        if ( a ) {
+            a->SetAttribute( value );
+        }
     }
     /// Sets the named attribute to value.
     void SetAttribute( const char* name, double value )		{
         XMLAttribute* a = FindOrCreateAttribute( name );
-        a->SetAttribute( value );
+        if ( a ) {
+            a->SetAttribute( value );
+        }
     }
     /// Sets the named attribute to value.
     void SetAttribute( const char* name, float value )		{
         XMLAttribute* a = FindOrCreateAttribute( name );
-        a->SetAttribute( value );
+        if ( a ) {
+            a->SetAttribute( value );
+        }
     }
 
     /**
@@ -1751,6 +1832,17 @@ public:
     */
     XMLError Parse( const char* xml, size_t nBytes=static_cast<size_t>(-1) );
 
+    /**
+    	Parse in place, without copying the input. The document keeps
+    	pointers into 'xml' and decodes text there as it is read, so the
+    	buffer is modified and must stay alive and untouched for as long
+    	as the document is used (until the next Parse or Clear).
+
+    	xml[nBytes] must be writable: it is set to 0, which also lets a
+    	caller parse only a prefix of a larger buffer.
+    */
+    XMLError ParseInSitu( char* xml, size_t nBytes=static_cast<size_t>(-1) );
+
     /**
     	Load an XML file from disk.
     	Returns XML_SUCCESS (0) on success, or
@@ -1907,6 +1999,49 @@ public:
     /// Clear the document, resetting it to the initial state.
     void Clear();
 
+    /**
+    	Keep memory between documents. When set, Clear() (and so every
+    	Parse()) returns nodes to the pools but keeps the pool blocks and
+    	the character buffer, so a long-lived document reparsed many times
+    	stops allocating once it has seen its largest input.
+    */
+    void SetRetainMemory( bool retain )	{
+        _retainMemory = retain;
+    }
+
+    /**
+    	Pre-size the character buffer and node pools. Returns false if the
+    	block allocator ran out; whatever was reserved before that is kept.
+    */
+    bool Reserve( size_t chars, size_t elements, size_t attributes, size_t texts, size_t comments = 0 );
+
+    /// Clear the document and release all retained memory, including reserved capacity.
+    void ReleaseMemory();
+
+    /// Peak node counts of the last parse, for sizing Reserve().
+    size_t ElementPeak() const		{ return _elementPool.PeakAllocs(); }
+    size_t AttributePeak() const	{ return _attributePool.PeakAllocs(); }
+    size_t TextPeak() const			{ return _textPool.PeakAllocs(); }
+    size_t CommentPeak() const		{ return _commentPool.PeakAllocs(); }
+
+    /// Bytes currently held by the pools and character buffer.
+    size_t ArenaBytes() const;
+
+    /**
+    	Only build the parts of the tree that lie on the given element
+    	paths. A path is a '/'-separated list of element names from the
+    	root, such as "rss/channel/item/title"; a "*" segment matches any
+    	name. The element at the end of a path is kept with all of its
+    	content. Elements leading to it are kept too, but their other
+    	children are skipped in the raw text without creating nodes, and
+    	comments along those levels are dropped. Skipped content is only
+    	checked for balanced tags, not fully validated.
+
+    	The strings are referenced, not copied, and must outlive the
+    	filter. Pass 0 to go back to parsing everything.
+    */
+    void SetPathFilter( const char* const* paths, size_t count );
+
 	/**
 		Copies this document to a target document.
 		The target will be completely cleared before the copy.
@@ -1940,6 +2075,9 @@ private:
     mutable StrPair	_errorStr;
     int             _errorLineNum;
     char*			_charBuffer;
+    char*			_charStore;			// owned storage behind _charBuffer
+    size_t			_charStoreCapacity;
+    bool			_retainMemory;
     int				_parseCurLineNum;
 	int				_parsingDepth;
 	// Memory tracking does add some overhead.
@@ -1958,6 +2096,24 @@ private:
 	static const char* _errorNames[XML_ERROR_COUNT];
 
     void Parse();
+    char* AcquireCharBuffer( size_t size );
+    void ResetPools();
+    void DiscardFailedParse();
+
+    // Compiled path filter: a trie of name segments, node 0 is the document
+    struct PathFilterNode {
+        const char* name;
+        size_t nameLength;
+        int firstChild;
+        int nextSibling;
+        bool keepSubtree;
+    };
+    enum { PATH_KEEP_ALL = -1 };
+    DynArray<PathFilterNode, 16> _pathFilter;
+    int _pathState;		// filter node of the element being parsed
+
+    char* SkipFiltered( char* p, int containerState, int* childState );
+    char* SkipElement( char* p );
 
     void SetError( XMLError error, int lineNum, const char* format, ... );
 
@@ -1988,8 +2144,12 @@ inline NodeType* XMLDocument::CreateUnlinkedNode( MemPoolT<PoolElementSize>& poo
 {
     TIXMLASSERT( sizeof( NodeType ) == PoolElementSize );
     TIXMLASSERT( sizeof( NodeType ) == pool.ItemSize() );
-    NodeType* returnNode = new (pool.Alloc()) NodeType( this );
-    TIXMLASSERT( returnNode );
+    void* mem = pool.Alloc();
+    if ( !mem ) {
+        SetError( XML_ERROR_OUT_OF_MEMORY, _parseCurLineNum, 0 );
+        return 0;
+    }
+    NodeType* returnNode = new (mem) NodeType( this );
     returnNode->_memPool = &pool;
 
 	_unlinked.Push(returnNode);
@@ -2384,4 +2544,4 @@ private:
 #   pragma warning(pop)
 #endif
 
-#endif // TINYXML2_INCLUDED
\ No newline at end of file
+#endif // TINYXML2_INCLUDED
\ No newline at end of file
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Gzip and fingerprint the web UI in data/ before uploading SPIFFS.
+
+For each page, script and stylesheet this writes <name>.gz next to it and
+records a content hash in data/assets.json. The firmware serves the .gz
+with that hash as a strong ETag. Pages reference scripts and stylesheets
+as /name?v=<hash>, so those can be cached as immutable; a new build
+changes the hash and with it the URL.
+
+Run it from the repository root whenever data/ changes:
+
+    python3 tools/build_web_assets.py
+"""
+
+import gzip
+import hashlib
+import json
+import os
+import re
+import sys
+
+DATA_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "data")
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".css": "text/css",
+}
+
+
+def content_hash(data):
+    return hashlib.sha256(data).hexdigest()[:16]
+
+
+def gzip_bytes(data):
+    # mtime=0 keeps the output identical between builds of the same input
+    return gzip.compress(data, compresslevel=9, mtime=0)
+
+
+def main():
+    names = sorted(n for n in os.listdir(DATA_DIR)
+                   if os.path.splitext(n)[1] in CONTENT_TYPES)
+    sources = {}
+    for name in names:
+        with open(os.path.join(DATA_DIR, name), "rb") as f:
+            sources[name] = f.read()
+
+    # Scripts and stylesheets first, so pages can point at their hashes
+    hashes = {n: content_hash(d) for n, d in sources.items() if not n.endswith(".html")}
+
+    def fingerprint(match):
+        attr, name = match.group(1).decode(), match.group(2).decode()
+        if name not in hashes:
+            return match.group(0)
+        return ('%s="/%s?v=%s"' % (attr, name, hashes[name])).encode()
+
+    manifest = {}
+    total_raw = total_gz = 0
+    for name in names:
+        data = sources[name]
+        if name.endswith(".html"):
+            data = re.sub(rb'(src|href)="/([\w.-]+)"', fingerprint, data)
+        packed = gzip_bytes(data)
+        with open(os.path.join(DATA_DIR, name + ".gz"), "wb") as f:
+            f.write(packed)
+
+        manifest["/" + name] = {
+            "etag": content_hash(data),
+            "type": CONTENT_TYPES[os.path.splitext(name)[1]],
+            "fingerprinted": not name.endswith(".html"),
+            "size": len(sources[name]),
+            "gzSize": len(packed),
+        }
+        total_raw += len(sources[name])
+        total_gz += len(packed)
+        print("%-12s %6d -> %5d bytes  etag %s" % (name, len(sources[name]), len(packed),
+                                                  manifest["/" + name]["etag"]))
+
+    with open(os.path.join(DATA_DIR, "assets.json"), "w") as f:
+        json.dump(manifest, f, indent=1, sort_keys=True)
+        f.write("\n")
+
+    print("%-12s %6d -> %5d bytes (%.0f%% smaller)" % (
+        "total", total_raw, total_gz, 100.0 * (total_raw - total_gz) / total_raw))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,111 @@
+#include "web_assets.h"
+
+#define ASSET_MANIFEST_PATH "/assets.json"
+#define IMMUTABLE_CACHE "public, max-age=31536000, immutable"
+
+struct WebAsset {
+  String path;
+  String etag;          // quoted, as sent
+  String contentType;
+  bool fingerprinted;   // referenced as path?v=<hash>
+  uint32_t size;
+  uint32_t gzSize;
+};
+
+AssetStats assetStats = {};
+
+static std::vector<WebAsset> assets;
+
+static const WebAsset* findAsset(const String& path) {
+  for (const auto& asset : assets) {
+    if (asset.path == path) return &asset;
+  }
+  return nullptr;
+}
+
+static void sendAsset(AsyncWebServerRequest* request, const WebAsset& asset) {
+  // Immutable only when the URL carries this exact build's hash
+  bool versioned = asset.fingerprinted && request->hasParam("v") &&
+                   asset.etag == "\"" + request->getParam("v")->value() + "\"";
+  const char* cacheControl = versioned ? IMMUTABLE_CACHE : "no-cache";
+  
+  if (request->hasHeader("If-None-Match") &&
+      request->getHeader("If-None-Match")->value().indexOf(asset.etag) >= 0) {
+    AsyncWebServerResponse* response = request->beginResponse(304);
+    response->addHeader("ETag", asset.etag);
+    response->addHeader("Cache-Control", cacheControl);
+    request->send(response);
+    assetStats.notModified++;
+    assetStats.bytesSaved += asset.size;
+    return;
+  }
+  
+  if (!request->hasHeader("Accept-Encoding") ||
+      request->getHeader("Accept-Encoding")->value().indexOf("gzip") < 0) {
+    request->send(SPIFFS, asset.path, asset.contentType);
+    assetStats.plain++;
+    assetStats.bytesSent += asset.size;
+    return;
+  }
+  
+  AsyncWebServerResponse* response = request->beginResponse(SPIFFS, asset.path + ".gz", asset.contentType);
+  response->addHeader("Content-Encoding", "gzip");
+  response->addHeader("ETag", asset.etag);
+  response->addHeader("Cache-Control", cacheControl);
+  request->send(response);
+  assetStats.served++;
+  assetStats.bytesSent += asset.gzSize;
+  assetStats.bytesSaved += asset.size - asset.gzSize;
+}
+
+bool sendWebAsset(AsyncWebServerRequest* request, const String& path) {
+  const WebAsset* asset = findAsset(path);
+  if (!asset) return false;
+  sendAsset(request, *asset);
+  return true;
+}
+
+void setupAssetRoutes() {
+  File file = SPIFFS.open(ASSET_MANIFEST_PATH, "r");
+  if (!file) {
+    Serial.println("No asset manifest - serving plain web files");
+    return;
+  }
+  
+  DynamicJsonDocument doc(1024);
+  DeserializationError error = deserializeJson(doc, file);
+  file.close();
+  if (error) {
+    Serial.printf("Failed to parse asset manifest: %s\n", error.c_str());
+    return;
+  }
+  
+  for (JsonPair entry : doc.as<JsonObject>()) {
+    String path = entry.key().c_str();
+    // Skip entries whose .gz didn't make it into the upload
+    if (!SPIFFS.exists(path + ".gz")) continue;
+    
+    WebAsset asset;
+    asset.path = path;
+    asset.etag = "\"" + entry.value()["etag"].as<String>() + "\"";
+    asset.contentType = entry.value()["type"].as<String>();
+    asset.fingerprinted = entry.value()["fingerprinted"] | false;
+    asset.size = entry.value()["size"] | 0;
+    asset.gzSize = entry.value()["gzSize"] | 0;
+    assets.push_back(asset);
+  }
+  
+  // Routes hold an index, so register them once the list is complete
+  for (size_t i = 0; i < assets.size(); i++) {
+    server.on(assets[i].path.c_str(), HTTP_GET, [i](AsyncWebServerRequest* request) {
+      sendAsset(request, assets[i]);
+    });
+    if (assets[i].path == "/index.html") {
+      server.on("/", HTTP_GET, [i](AsyncWebServerRequest* request) {
+        sendAsset(request, assets[i]);
+      });
+    }
+  }
+  
+  Serial.printf("Serving %u precompressed web assets\n", assets.size());
+}
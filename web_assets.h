@@ -0,0 +1,30 @@
+#ifndef WEB_ASSETS_H
+#define WEB_ASSETS_H
+
+#include "config.h"
+
+// Precompressed web UI. tools/build_web_assets.py writes <file>.gz and
+// data/assets.json (content hash, type, sizes); each listed file is then
+// served gzipped with a strong ETag:
+//   - a matching If-None-Match gets 304 without touching SPIFFS
+//   - scripts/styles requested with their ?v=<hash> are cached as
+//     immutable; everything else is revalidated on each load
+// Without assets.json, serveStatic() serves the plain files as before.
+
+struct AssetStats {
+  uint32_t served;       // sent gzipped
+  uint32_t notModified;  // answered 304
+  uint32_t plain;        // client without gzip support
+  uint32_t bytesSent;
+  uint32_t bytesSaved;   // against sending the plain file every time
+};
+
+extern AssetStats assetStats;
+
+// Registers a route per asset; call before serveStatic()
+void setupAssetRoutes();
+
+// Sends path as an asset; false if it isn't in the manifest
+bool sendWebAsset(AsyncWebServerRequest* request, const String& path);
+
+#endif
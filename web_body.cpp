@@ -0,0 +1,164 @@
+#include "web_body.h"
+#include "mem_policy.h"
+#include "log.h"
+
+// One body being received; lives in the request's _tempObject
+struct BodyBuffer {
+  char* data;
+  size_t length;    // as announced by the client
+  size_t received;
+  bool refused;     // over the cap, or no memory for it
+};
+
+// A parsed body waiting for the worker. Strings in the document point
+// into body, so both are freed together.
+struct ConfigJob {
+  ConfigApplyFn apply;
+  DynamicJsonDocument* doc;
+  char* body;
+};
+
+static QueueHandle_t configQueue = nullptr;
+
+static void releaseBody(AsyncWebServerRequest* request) {
+  BodyBuffer* body = static_cast<BodyBuffer*>(request->_tempObject);
+  if (!body) return;
+  request->_tempObject = nullptr;
+  memFree(body->data);
+  memFree(body);
+}
+
+static void collectBody(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                        size_t index, size_t total, size_t maxBody, bool psram) {
+  if (index == 0 && !request->_tempObject) {
+    BodyBuffer* body = static_cast<BodyBuffer*>(memAlloc(sizeof(BodyBuffer), ALLOC_HOT));
+    if (!body) return;
+    body->data = nullptr;
+    body->length = total;
+    body->received = 0;
+    body->refused = total > maxBody;
+    if (!body->refused) {
+      // One spare byte so the parser sees a terminated string
+      body->data = static_cast<char*>(memAlloc(total + 1, psram ? ALLOC_BULK : ALLOC_HOT));
+      body->refused = body->data == nullptr;
+    }
+    request->_tempObject = body;
+    
+    // The server would free() it on its own if the client went away
+    // mid-body; release it through the policy instead
+    request->onDisconnect([request]() {
+      releaseBody(request);
+    });
+  }
+  
+  BodyBuffer* body = static_cast<BodyBuffer*>(request->_tempObject);
+  if (!body || body->refused) return;
+  if (index + len > body->length) {
+    body->refused = true;
+    return;
+  }
+  memcpy(body->data + index, data, len);
+  body->received += len;
+}
+
+// Parses the collected body; on failure the error response is sent and
+// nullptr returned. The document's strings point into the body, which
+// stays with the request until releaseBody().
+static DynamicJsonDocument* parseBody(AsyncWebServerRequest* request, size_t maxBody) {
+  BodyBuffer* body = static_cast<BodyBuffer*>(request->_tempObject);
+  if (!body || body->length == 0) {
+    request->send(400, "text/plain", "Missing request body");
+    return nullptr;
+  }
+  if (body->refused) {
+    bool tooLarge = body->length > maxBody;
+    releaseBody(request);
+    request->send(tooLarge ? 413 : 503, "text/plain", tooLarge ? "Request body too large" : "Out of memory");
+    return nullptr;
+  }
+  if (body->received != body->length) {
+    releaseBody(request);
+    request->send(400, "text/plain", "Incomplete request body");
+    return nullptr;
+  }
+  
+  // Parsed in place: strings stay in the body buffer rather than being
+  // copied into the document
+  body->data[body->length] = '\0';
+  DynamicJsonDocument* doc = new DynamicJsonDocument(body->length + CONFIG_DOC_SLACK);
+  DeserializationError error = deserializeJson(*doc, body->data, body->length);
+  if (error) {
+    delete doc;
+    releaseBody(request);
+    request->send(400, "text/plain", String("Invalid JSON: ") + error.c_str());
+    return nullptr;
+  }
+  return doc;
+}
+
+static void handleConfigPost(AsyncWebServerRequest* request, size_t maxBody,
+                             ConfigApplyFn apply, const char* okMessage,
+                             ConfigCheckFn check) {
+  DynamicJsonDocument* doc = parseBody(request, maxBody);
+  if (!doc) return;
+  
+  String error;
+  if (check && !check(*doc, error)) {
+    delete doc;
+    releaseBody(request);
+    request->send(400, "text/plain", error);
+    return;
+  }
+  
+  BodyBuffer* body = static_cast<BodyBuffer*>(request->_tempObject);
+  ConfigJob job = {apply, doc, body->data};
+  if (xQueueSend(configQueue, &job, 0) != pdTRUE) {
+    delete doc;
+    releaseBody(request);
+    request->send(503, "text/plain", "Busy, try again");
+    return;
+  }
+  
+  // The worker owns the data now; only the wrapper goes
+  body->data = nullptr;
+  releaseBody(request);
+  request->send(200, "text/plain", okMessage);
+}
+
+void onConfigPost(const char* uri, size_t maxBody, bool psram,
+                  ConfigApplyFn apply, const char* okMessage,
+                  ConfigCheckFn check) {
+  server.on(uri, HTTP_POST, [maxBody, apply, okMessage, check](AsyncWebServerRequest* request) {
+    handleConfigPost(request, maxBody, apply, okMessage, check);
+  }, NULL, [maxBody, psram](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+    collectBody(request, data, len, index, total, maxBody, psram);
+  });
+}
+
+void onJsonBody(const char* uri, WebRequestMethodComposite method, size_t maxBody,
+                JsonBodyHandler handler) {
+  server.on(uri, method, [maxBody, handler](AsyncWebServerRequest* request) {
+    DynamicJsonDocument* doc = parseBody(request, maxBody);
+    if (!doc) return;
+    handler(request, *doc);
+    delete doc;
+    releaseBody(request);
+  }, NULL, [maxBody](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+    collectBody(request, data, len, index, total, maxBody, false);
+  });
+}
+
+static void configWorkerTask(void* parameter) {
+  ConfigJob job;
+  for (;;) {
+    if (xQueueReceive(configQueue, &job, portMAX_DELAY) != pdTRUE) continue;
+    job.apply(*job.doc);
+    delete job.doc;
+    memFree(job.body);
+  }
+}
+
+void startConfigWorker() {
+  configQueue = xQueueCreate(CONFIG_QUEUE_LENGTH, sizeof(ConfigJob));
+  xTaskCreate(configWorkerTask, "Config_Worker", 8192, NULL, 1, NULL);
+}
@@ -0,0 +1,41 @@
+#ifndef WEB_BODY_H
+#define WEB_BODY_H
+
+#include "config.h"
+
+// POST bodies for the JSON config endpoints.
+//
+// AsyncTCP hands a body over in pieces as segments arrive, each with its
+// offset and the total length. The pieces are collected into one buffer
+// (capped per route, optionally in PSRAM), parsed in place once the last
+// one is in, and the parsed document is applied by a worker task, so
+// flash writes and feed rebuilds never stall the network task.
+
+#define CONFIG_QUEUE_LENGTH 4
+#define CONFIG_DOC_SLACK 512  // parsed document size beyond the body length
+
+// Applies a parsed config body; runs on the config worker
+typedef void (*ConfigApplyFn)(DynamicJsonDocument& doc);
+
+// Checks a parsed config body on the network task before it is queued;
+// false refuses it with 400 and 'error' as the message
+typedef bool (*ConfigCheckFn)(DynamicJsonDocument& doc, String& error);
+
+// Handles a parsed body on the network task and sends the response.
+// For quick in-memory edits only.
+typedef std::function<void(AsyncWebServerRequest* request, DynamicJsonDocument& doc)> JsonBodyHandler;
+
+// Registers a POST route whose JSON body is collected, checked and
+// handed to 'apply'. Bodies over maxBody are refused with 413, and
+// bodies 'check' rejects with 400.
+void onConfigPost(const char* uri, size_t maxBody, bool psram,
+                  ConfigApplyFn apply, const char* okMessage,
+                  ConfigCheckFn check = nullptr);
+
+// Same collection and checks, but the handler answers the request itself
+void onJsonBody(const char* uri, WebRequestMethodComposite method, size_t maxBody,
+                JsonBodyHandler handler);
+
+void startConfigWorker();
+
+#endif
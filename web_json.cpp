@@ -0,0 +1,155 @@
+#include "web_json.h"
+#include <memory>
+
+// Keeps only the bytes of a serialization that fall in [skip, skip + capacity)
+class WindowPrint : public Print {
+public:
+  WindowPrint(uint8_t* out, size_t capacity, size_t skip)
+    : out(out), capacity(capacity), skip(skip) {}
+  
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  
+  size_t write(const uint8_t* data, size_t len) override {
+    size_t consumed = len;
+    if (skip >= len) {
+      skip -= len;
+      return consumed;
+    }
+    data += skip;
+    len -= skip;
+    skip = 0;
+    
+    size_t room = capacity - written;
+    if (len > room) len = room;
+    memcpy(out + written, data, len);
+    written += len;
+    return consumed;
+  }
+  
+  size_t length() const { return written; }
+
+private:
+  uint8_t* out;
+  size_t capacity;
+  size_t skip;
+  size_t written = 0;
+};
+
+void sendJson(AsyncWebServerRequest* request, DynamicJsonDocument&& doc) {
+  auto held = std::make_shared<DynamicJsonDocument>(std::move(doc));
+  
+  request->send(request->beginChunkedResponse("application/json",
+    [held](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+      WindowPrint window(buffer, maxLen, index);
+      serializeJson(*held, window);
+      return window.length();
+    }));
+}
+
+// Where a /feeds response is: the entry being sent and how much of it
+// has gone out
+struct FeedStreamState {
+  size_t nextFeed = 0;
+  bool opened = false;
+  bool closed = false;
+  size_t entries = 0;
+  char piece[FEED_JSON_MAX];
+  size_t pieceLen = 0;
+  size_t piecePos = 0;
+  // An entry larger than 'piece', copied so it stays the same while it
+  // goes out over several pieces
+  RSSFeed longFeed;
+  size_t longLen = 0;
+  size_t longPos = 0;
+};
+
+static void feedToJson(const RSSFeed& feed, JsonDocument& doc) {
+  doc["id"] = feed.id;
+  doc["name"] = feed.name.c_str();
+  doc["url"] = feed.url.c_str();
+  doc["enabled"] = feed.enabled;
+}
+
+// Serializes the next entry (or the closing bracket) into state.piece;
+// false when the list is complete
+static bool nextFeedPiece(FeedStreamState& state) {
+  state.pieceLen = 0;
+  state.piecePos = 0;
+  
+  if (state.longPos < state.longLen) {
+    StaticJsonDocument<128> doc;
+    feedToJson(state.longFeed, doc);
+    WindowPrint window(reinterpret_cast<uint8_t*>(state.piece), sizeof(state.piece), state.longPos);
+    serializeJson(doc, window);
+    state.pieceLen = window.length();
+    state.longPos += state.pieceLen;
+    if (state.longPos >= state.longLen) {
+      state.longFeed = RSSFeed();
+      state.longLen = state.longPos = 0;
+    }
+    return state.pieceLen > 0;
+  }
+  
+  if (!state.opened) {
+    state.opened = true;
+    state.piece[state.pieceLen++] = '[';
+  }
+  
+  // Feeds can be edited between chunks; each entry is read under the
+  // lock and the list simply ends wherever it ends by then
+  while (!state.closed) {
+    lockFeeds();
+    if (state.nextFeed >= feeds.size()) {
+      unlockFeeds();
+      state.closed = true;
+      state.piece[state.pieceLen++] = ']';
+      break;
+    }
+    
+    size_t index = state.nextFeed++;
+    StaticJsonDocument<128> doc;
+    feedToJson(feeds[index], doc);
+    
+    if (state.entries++ > 0) {
+      state.piece[state.pieceLen++] = ',';
+    }
+    size_t needed = measureJson(doc) + 1;  // terminator
+    if (state.pieceLen + needed > sizeof(state.piece)) {
+      // Goes out over the next pieces
+      state.longFeed = feeds[index];
+      state.longLen = needed - 1;
+      unlockFeeds();
+      break;
+    }
+    state.pieceLen += serializeJson(doc, state.piece + state.pieceLen, sizeof(state.piece) - state.pieceLen);
+    unlockFeeds();
+    break;
+  }
+  
+  // Only a separator or nothing yet; start on the long entry right away
+  if (state.pieceLen == 0 && state.longLen > 0) {
+    return nextFeedPiece(state);
+  }
+  return state.pieceLen > 0;
+}
+
+void sendFeedsJson(AsyncWebServerRequest* request) {
+  auto state = std::make_shared<FeedStreamState>();
+  
+  request->send(request->beginChunkedResponse("application/json",
+    [state](uint8_t* buffer, size_t maxLen, size_t index) -> size_t {
+      size_t written = 0;
+      while (written < maxLen) {
+        if (state->piecePos == state->pieceLen && !nextFeedPiece(*state)) {
+          break;
+        }
+        size_t n = min(state->pieceLen - state->piecePos, maxLen - written);
+        memcpy(buffer + written, state->piece + state->piecePos, n);
+        state->piecePos += n;
+        written += n;
+      }
+      return written;
+    }));
+}
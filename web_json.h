@@ -0,0 +1,22 @@
+#ifndef WEB_JSON_H
+#define WEB_JSON_H
+
+#include "config.h"
+
+// JSON responses that are serialized straight into the outgoing chunks.
+//
+// No response String is built: each time the server asks for the next
+// chunk, the document is serialized again and only the bytes for that
+// chunk are kept. Documents here are a few KB, so re-serializing costs
+// less than holding a full copy. The feed list is built one feed at a
+// time instead, so its memory doesn't grow with the number of feeds.
+
+#define FEED_JSON_MAX 768  // piece buffer; longer feed entries span several pieces
+
+// Takes the document over; it lives until the response is sent
+void sendJson(AsyncWebServerRequest* request, DynamicJsonDocument&& doc);
+
+// GET /feeds
+void sendFeedsJson(AsyncWebServerRequest* request);
+
+#endif
@@ -2,10 +2,477 @@
 #include "p10_display.h"
 #include "wifi_manager.h"
 #include "rss_handler.h"
+#include "rss_filter.h"
+#include "rss_dedup.h"
+#include "rss_governor.h"
+#include "mem_policy.h"
+#include "log.h"
+#include "web_assets.h"
+#include "web_json.h"
+#include "web_body.h"
+#include "config_store.h"
+#include "boot_profile.h"
 #include <Update.h>
+#include <esp_heap_caps.h>
+
+// Push channel for dashboards. One task builds each event once and the
+// event source fans it out to every client, so open dashboards cost
+// nothing per client beyond the socket write, and nothing at all when
+// none is connected.
+#define PUSH_TICK_MS 250           // content changes go out this quickly
+#define PUSH_STATUS_MIN_MS 1000    // fetch progress and Wi-Fi
+#define PUSH_METRICS_MIN_MS 5000   // memory and counters, changed fields only
+
+static AsyncEventSource events("/events");
+static volatile bool pushSnapshot = true;  // a client connected: resend everything
+
+// Metrics sent as deltas: only fields that changed since the last push
+enum PushMetric {
+  METRIC_FREE_HEAP = 0,
+  METRIC_LARGEST_BLOCK,
+  METRIC_MIN_FREE_EVER,
+  METRIC_FREE_PSRAM,
+  METRIC_LOG_DROPPED,
+  METRIC_ASSET_BYTES_SAVED,
+  METRIC_COUNT
+};
+
+static const char* const metricNames[METRIC_COUNT] = {
+  "freeMemory", "largestBlock", "minFreeEver", "freePsram", "logDropped", "assetBytesSaved"
+};
+
+static void webPushTask(void* parameter) {
+  uint32_t eventId = 0;
+  uint32_t lastContentSeq = 0;
+  char lastTime[32] = "";
+  char lastStatus[256] = "";
+  uint32_t lastMetrics[METRIC_COUNT];
+  unsigned long lastStatusPush = 0;
+  unsigned long lastMetricsPush = 0;
+  
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(PUSH_TICK_MS));
+    if (events.count() == 0) continue;
+    
+    unsigned long now = millis();
+    if (pushSnapshot) {
+      pushSnapshot = false;
+      lastContentSeq = currentContentSeq() - 1;
+      lastTime[0] = '\0';
+      lastStatus[0] = '\0';
+      memset(lastMetrics, 0xFF, sizeof(lastMetrics));
+      lastStatusPush = now - PUSH_STATUS_MIN_MS;
+      lastMetricsPush = now - PUSH_METRICS_MIN_MS;
+    }
+    
+    uint32_t seq = currentContentSeq();
+    if (seq != lastContentSeq) {
+      lastContentSeq = seq;
+      events.send(currentContentText().c_str(), "content", ++eventId);
+    }
+    
+    char time[32];
+    snprintf(time, sizeof(time), "%s %s", getCurrentTimeString().c_str(), getCurrentDateString().c_str());
+    if (strcmp(time, lastTime) != 0) {
+      strlcpy(lastTime, time, sizeof(lastTime));
+      events.send(time, "time", ++eventId);
+    }
+    
+    if (now - lastStatusPush >= PUSH_STATUS_MIN_MS) {
+      StaticJsonDocument<384> doc;
+      doc["wifi"] = WiFi.isConnected() ? "Connected (" + WiFi.localIP().toString() + ")" : "Disconnected";
+      JsonObject fetch = doc.createNestedObject("fetch");
+      fetch["inProgress"] = fetchStatus.inProgress;
+      fetch["feedsDone"] = fetchStatus.feedsDone;
+      fetch["feedsTotal"] = fetchStatus.feedsTotal;
+      fetch["succeeded"] = fetchStatus.succeeded;
+      fetch["failed"] = fetchStatus.failed;
+      fetch["headlines"] = fetchStatus.lastHeadlines;
+      
+      char status[sizeof(lastStatus)];
+      serializeJson(doc, status, sizeof(status));
+      if (strcmp(status, lastStatus) != 0) {
+        strlcpy(lastStatus, status, sizeof(lastStatus));
+        events.send(status, "status", ++eventId);
+      }
+      lastStatusPush = now;
+    }
+    
+    if (now - lastMetricsPush >= PUSH_METRICS_MIN_MS) {
+      uint32_t values[METRIC_COUNT];
+      values[METRIC_FREE_HEAP] = ESP.getFreeHeap();
+      values[METRIC_LARGEST_BLOCK] = ESP.getMaxAllocHeap();
+      values[METRIC_MIN_FREE_EVER] = ESP.getMinFreeHeap();
+      values[METRIC_FREE_PSRAM] = psramFound() ? ESP.getFreePsram() : 0;
+      values[METRIC_LOG_DROPPED] = logDropped();
+      values[METRIC_ASSET_BYTES_SAVED] = assetStats.bytesSaved;
+      
+      StaticJsonDocument<256> doc;
+      for (int i = 0; i < METRIC_COUNT; i++) {
+        if (values[i] != lastMetrics[i]) {
+          doc[metricNames[i]] = values[i];
+          lastMetrics[i] = values[i];
+        }
+      }
+      if (doc.size() > 0) {
+        char metrics[256];
+        serializeJson(doc, metrics, sizeof(metrics));
+        events.send(metrics, "metrics", ++eventId);
+      }
+      lastMetricsPush = now;
+    }
+  }
+}
+
+static void setupEventRoutes() {
+  events.onConnect([](AsyncEventSourceClient* client) {
+    pushSnapshot = true;
+  });
+  server.addHandler(&events);
+  
+  // Below the display loop's priority, so pushing never delays a frame
+  xTaskCreate(webPushTask, "Web_Push", 4096, NULL, tskIDLE_PRIORITY, NULL);
+}
+
+// Config bodies, applied on the config worker (see web_body.h)
+#define MAX_SETTINGS_BODY 4096
+#define MAX_FEEDS_BODY 32768
+
+static void applySettings(DynamicJsonDocument& doc) {
+  // Only this task writes 'settings', so it reads them without the lock
+  String tzRegion = doc["tzRegion"] | settings.tzRegion;
+  String blockKeywords = doc["blockKeywords"] | settings.blockKeywords;
+  String boostKeywords = doc["boostKeywords"] | settings.boostKeywords;
+  bool interleave = doc["interleaveFeeds"] | settings.interleaveFeeds;
+  bool reorder = interleave != settings.interleaveFeeds;
+  bool recompile = blockKeywords != settings.blockKeywords || boostKeywords != settings.boostKeywords;
+  
+  lockSettings();
+  settings.fetchInterval = doc["fetchInterval"] | settings.fetchInterval;
+  settings.maxNewsAgeHours = doc["maxNewsAgeHours"] | settings.maxNewsAgeHours;
+  settings.maxHeadlinesPerFeed = doc["maxHeadlinesPerFeed"] | settings.maxHeadlinesPerFeed;
+  settings.interleaveFeeds = interleave;
+  settings.tzRegion = tzRegion;
+  settings.blockKeywords = blockKeywords;
+  settings.boostKeywords = boostKeywords;
+  unlockSettings();
+  
+  if (reorder) rebuildHeadlineOrder();
+  if (recompile) compileKeywordFilter();
+  
+  saveSettings();
+  applyTimezone();
+}
+
+static void applyFeeds(DynamicJsonDocument& doc) {
+  lockFeeds();
+  feeds.clear();
+  JsonArray array = doc.as<JsonArray>();
+  
+  for (JsonObject obj : array) {
+    RSSFeed feed;
+    feed.id = obj["id"] | 0;
+    feed.name = obj["name"].as<String>();
+    feed.url = obj["url"].as<String>();
+    feed.enabled = obj["enabled"].as<bool>();
+    feeds.push_back(feed);
+  }
+  normalizeFeedIds();
+  feedListVersion++;
+  unlockFeeds();
+  
+  // A bulk replace can drop or renumber feeds, so start the headlines over
+  clearRSSHeadlines();
+  resetDedup();
+  saveFeedsToFile();
+  
+  // Refill from the new list; a cycle already running starts over with it
+  requestRSSFetch();
+}
+
+static void applyDisplaySettings(DynamicJsonDocument& doc) {
+  lockDisplaySettings();
+  if (doc.containsKey("brightness")) {
+    setDisplayBrightness(doc["brightness"]);
+  }
+  if (doc.containsKey("scrollSpeed")) {
+    setScrollSpeed(doc["scrollSpeed"]);
+  }
+  if (doc.containsKey("scrollDirection")) {
+    setScrollDirection(doc["scrollDirection"]);
+  }
+  if (doc.containsKey("panelType")) {
+    setPanelType(static_cast<PanelType>(doc["panelType"].as<int>()));
+  }
+  if (doc.containsKey("fontType")) {
+    setFontType(static_cast<FontType>(doc["fontType"].as<int>()));
+  }
+  if (doc.containsKey("animationType")) {
+    setAnimationType(static_cast<AnimationType>(doc["animationType"].as<int>()));
+  }
+  if (doc.containsKey("animationEnabled")) {
+    displaySettings.animationEnabled = doc["animationEnabled"];
+  }
+  if (doc.containsKey("marqueeMode")) {
+    displaySettings.marqueeMode = doc["marqueeMode"];
+  }
+  if (doc.containsKey("layout")) {
+    // The display loop picks the new layout up on its next frame
+    displaySettings.layout = constrain(doc["layout"].as<int>(), LAYOUT_SINGLE, LAYOUT_CLOCK_TICKER);
+  }
+  if (doc.containsKey("previewFps")) {
+    displaySettings.previewFps = constrain(doc["previewFps"].as<int>(), 1, PREVIEW_MAX_FPS);
+  }
+  unlockDisplaySettings();
+  
+  saveDisplaySettings();
+}
+
+// Key of a content type in /display/content bodies; nullptr if it has none
+static const char* contentKey(ContentType type) {
+  switch (type) {
+    case CONTENT_TIME:
+      return "time";
+    case CONTENT_DATE:
+      return "date";
+    case CONTENT_RSS_FEEDS:
+      return "rss";
+    case CONTENT_QUOTE_OF_DAY:
+      return "quotes";
+    case CONTENT_FUN_FACTS:
+      return "facts";
+    default:
+      return nullptr;
+  }
+}
+
+static bool checkDisplayContent(DynamicJsonDocument& doc, String& error) {
+  // Dwell times are checked as a pair, a missing one taking its current value
+  JsonObject schedule = doc["schedule"];
+  if (schedule.isNull()) return true;
+  for (const auto& content : scrollContents) {
+    const char* key = contentKey(content.type);
+    if (!key) continue;
+    JsonObject rules = schedule[key];
+    if (rules.isNull()) continue;
+    
+    JsonVariant minDwell = rules["minDwell"];
+    JsonVariant maxDwell = rules["maxDwell"];
+    if ((!minDwell.isNull() && !minDwell.is<uint32_t>()) ||
+        (!maxDwell.isNull() && !maxDwell.is<uint32_t>()) ||
+        !dwellInRange(minDwell | content.schedule.minDwellMs, maxDwell | content.schedule.maxDwellMs)) {
+      error = String("Invalid dwell for ") + key + ": minDwell must be " + DWELL_MIN_MS + "-" +
+              DWELL_MAX_MS + " ms, maxDwell 0 or from minDwell to " + DWELL_MAX_MS + " ms";
+      return false;
+    }
+  }
+  return true;
+}
+
+static void applyDisplayContent(DynamicJsonDocument& doc) {
+  // Update scroll content enable/disable status, and rotation weights
+  // and dwell times from an optional "schedule" object keyed the same way
+  JsonObject schedule = doc["schedule"];
+  lockDisplaySettings();
+  for (auto& content : scrollContents) {
+    const char* key = contentKey(content.type);
+    if (!key) continue;
+    content.enabled = doc[key] | content.enabled;
+    
+    JsonObject rules = schedule[key];
+    if (!rules.isNull()) {
+      content.schedule.weight = constrain(rules["weight"] | content.schedule.weight, 0, 100);
+      content.schedule.minDwellMs = rules["minDwell"] | content.schedule.minDwellMs;
+      content.schedule.maxDwellMs = rules["maxDwell"] | content.schedule.maxDwellMs;
+      content.schedule.advanceOnComplete = rules["advanceOnComplete"] | content.schedule.advanceOnComplete;
+      clampDwell(content.schedule);
+    }
+  }
+  unlockDisplaySettings();
+  
+  saveDisplaySettings();
+}
+
+// Single-feed edits change 'feeds' in place on the network task (a few
+// microseconds under the lock); the config store writes the file later
+#define MAX_FEED_BODY 1024
+
+// Nothing that JSON would have to escape, so the URL serializes at its
+// own length
+static bool validFeedUrl(const String& url) {
+  if (url.length() > MAX_FEED_URL) return false;
+  if (!url.startsWith("http://") && !url.startsWith("https://")) return false;
+  for (size_t i = 0; i < url.length(); i++) {
+    char c = url[i];
+    if (c <= ' ' || c == '"' || c == '\\') return false;
+  }
+  return true;
+}
+
+static bool validFeedName(const String& name) {
+  return name.length() > 0 && name.length() <= MAX_FEED_NAME;
+}
+
+// The feed named by ?id=, as an index into 'feeds'; sends 400/404 and
+// returns -1 if there is none. Caller holds the feeds lock.
+static int requestedFeedIndex(AsyncWebServerRequest* request, uint16_t& id) {
+  if (!request->hasParam("id")) {
+    request->send(400, "text/plain", "Missing id parameter");
+    return -1;
+  }
+  id = request->getParam("id")->value().toInt();
+  int index = findFeedIndex(id);
+  if (index < 0) {
+    request->send(404, "text/plain", "No feed with that id");
+  }
+  return index;
+}
+
+static void sendFeed(AsyncWebServerRequest* request, int code, const RSSFeed& feed) {
+  StaticJsonDocument<128> doc;
+  doc["id"] = feed.id;
+  doc["name"] = feed.name.c_str();
+  doc["url"] = feed.url.c_str();
+  doc["enabled"] = feed.enabled;
+  // Only a feed stored through the bulk /feeds route can be this long
+  char json[FEED_JSON_MAX];
+  if (measureJson(doc) >= sizeof(json)) {
+    request->send(500, "text/plain", "Feed entry too long to send; shorten it in the feed list");
+    return;
+  }
+  serializeJson(doc, json, sizeof(json));
+  request->send(code, "application/json", json);
+}
+
+static void setupFeedRoutes() {
+  server.on("/feed", HTTP_GET, [](AsyncWebServerRequest* request) {
+    uint16_t id;
+    lockFeeds();
+    int index = requestedFeedIndex(request, id);
+    if (index >= 0) {
+      sendFeed(request, 200, feeds[index]);
+    }
+    unlockFeeds();
+  });
+  
+  // Add one feed; replies with it, including its new id
+  onJsonBody("/feed", HTTP_POST, MAX_FEED_BODY, [](AsyncWebServerRequest* request, DynamicJsonDocument& doc) {
+    RSSFeed feed;
+    feed.name = doc["name"] | "";
+    feed.url = doc["url"] | "";
+    feed.enabled = doc["enabled"] | true;
+    if (!validFeedName(feed.name) || !validFeedUrl(feed.url)) {
+      request->send(400, "text/plain", "Feed needs a name of up to " + String(MAX_FEED_NAME) +
+                    " characters and an http(s) URL of up to " + String(MAX_FEED_URL));
+      return;
+    }
+    
+    lockFeeds();
+    feed.id = assignFeedId();
+    feeds.push_back(feed);
+    unlockFeeds();
+    
+    saveFeedsToFile();
+    if (feed.enabled) {
+      requestFeedFetch(feed.id);
+    }
+    sendFeed(request, 201, feed);
+  });
+  
+  // Change any of name/url/enabled of one feed
+  onJsonBody("/feed", HTTP_PUT, MAX_FEED_BODY, [](AsyncWebServerRequest* request, DynamicJsonDocument& doc) {
+    String url = doc["url"] | "";
+    if (doc.containsKey("url") && !validFeedUrl(url)) {
+      request->send(400, "text/plain", "Feed URL must be http(s), up to " + String(MAX_FEED_URL) + " characters");
+      return;
+    }
+    String name = doc["name"] | "";
+    if (doc.containsKey("name") && !validFeedName(name)) {
+      request->send(400, "text/plain", "Feed name must be 1 to " + String(MAX_FEED_NAME) + " characters");
+      return;
+    }
+    
+    uint16_t id;
+    lockFeeds();
+    int index = requestedFeedIndex(request, id);
+    if (index < 0) {
+      unlockFeeds();
+      return;
+    }
+    RSSFeed& feed = feeds[index];
+    bool wasEnabled = feed.enabled;
+    bool urlChanged = doc.containsKey("url") && url != feed.url;
+    if (doc.containsKey("name")) feed.name = name;
+    if (urlChanged) feed.url = url;
+    if (doc.containsKey("enabled")) feed.enabled = doc["enabled"];
+    RSSFeed updated = feed;
+    unlockFeeds();
+    
+    // Headlines from the old URL, or from a feed now off, go right away
+    if (urlChanged || (wasEnabled && !updated.enabled)) {
+      clearFeedHeadlines(id);
+      rebuildHeadlineOrder();
+    }
+    if (updated.enabled && (urlChanged || !wasEnabled)) {
+      requestFeedFetch(id);
+    }
+    saveFeedsToFile();
+    sendFeed(request, 200, updated);
+  });
+  
+  server.on("/feed", HTTP_DELETE, [](AsyncWebServerRequest* request) {
+    uint16_t id;
+    lockFeeds();
+    int index = requestedFeedIndex(request, id);
+    if (index < 0) {
+      unlockFeeds();
+      return;
+    }
+    feeds.erase(feeds.begin() + index);
+    unlockFeeds();
+    
+    removeFeedHeadlines(id);
+    removeFeedFingerprints(id);
+    saveFeedsToFile();
+    request->send(200, "text/plain", "Feed removed");
+  });
+}
+
+// Live panel preview. Frames are encoded on the display loop; this side
+// only tracks watchers and hands frames to the socket.
+#define PREVIEW_MAX_CLIENTS 2
+
+static AsyncWebSocket previewSocket("/ws/preview");
+
+static bool previewSocketReady() {
+  previewSocket.cleanupClients(PREVIEW_MAX_CLIENTS);
+  return previewSocket.availableForWriteAll();
+}
+
+static void previewSocketSend(const uint8_t* data, size_t len) {
+  previewSocket.binaryAll(data, len);
+}
+
+static void setupPreviewRoutes() {
+  previewSocket.onEvent([](AsyncWebSocket* socket, AsyncWebSocketClient* client,
+                           AwsEventType type, void* arg, uint8_t* data, size_t len) {
+    if (type == WS_EVT_CONNECT) {
+      // Diffs mean nothing to a new client without a full frame first
+      requestPreviewKeyframe();
+      setPreviewWatchers(socket->count());
+    } else if (type == WS_EVT_DISCONNECT) {
+      setPreviewWatchers(socket->count());
+    }
+  });
+  server.addHandler(&previewSocket);
+  setPreviewSink(previewSocketReady, previewSocketSend);
+}
 
 void setupWebServer() {
-  Serial.println("Setting up web server...");
+  LOG_INFO(WEB, "Setting up web server...\n");
+  
+  // Applies config POST bodies off the network task
+  startConfigWorker();
   
   // Setup WiFi routes
   setupWiFiRoutes();
@@ -16,18 +483,149 @@ void setupWebServer() {
   // Setup OTA update routes
   setupOTARoutes();
   
-  // Serve static files from SPIFFS
+  // Dashboard push channel
+  setupEventRoutes();
+  
+  // Live panel preview
+  setupPreviewRoutes();
+  
+  // Precompressed UI first; anything not in the manifest falls through
+  // to the plain files
+  setupAssetRoutes();
   server.serveStatic("/", SPIFFS, "/").setDefaultFile("index.html");
   
   // System status endpoint
   server.on("/status", HTTP_GET, [](AsyncWebServerRequest* request) {
-    DynamicJsonDocument doc(512);
+    DynamicJsonDocument doc(4096);
     doc["freeMemory"] = ESP.getFreeHeap();
+    doc["logDropped"] = logDropped();
+    
+    JsonObject web = doc.createNestedObject("webAssets");
+    web["served"] = assetStats.served;
+    web["notModified"] = assetStats.notModified;
+    web["plain"] = assetStats.plain;
+    web["bytesSent"] = assetStats.bytesSent;
+    web["bytesSaved"] = assetStats.bytesSaved;
+    
+    JsonObject store = doc.createNestedObject("configStore");
+    for (int i = 0; i < CONFIG_FILE_COUNT; i++) {
+      const ConfigFileStats& file = configStoreStats.files[i];
+      JsonObject entry = store.createNestedObject(configFileName(static_cast<ConfigFile>(i)));
+      entry["requests"] = file.requests;
+      entry["writes"] = file.writes;
+      entry["bytes"] = file.bytes;
+      entry["failures"] = file.failures;
+      entry["generation"] = file.generation;
+      entry["source"] = configSourceName(file.source);
+      entry["loadUs"] = file.loadUs;
+      entry["loadBytes"] = file.loadBytes;
+    }
+    store["recovered"] = configStoreStats.recovered;
+    store["corrupt"] = configStoreStats.corrupt;
+    
+    JsonObject preview = doc.createNestedObject("preview");
+    preview["frames"] = previewStats.frames;
+    preview["keyframes"] = previewStats.keyframes;
+    preview["bytes"] = previewStats.bytes;
+    preview["skippedBusy"] = previewStats.skippedBusy;
+    preview["lastEncodeUs"] = previewStats.lastEncodeUs;
+    preview["avgEncodeUs"] = previewStats.avgEncodeUs;
+    preview["maxEncodeUs"] = previewStats.maxEncodeUs;
+    
+    JsonObject boot = doc.createNestedObject("boot");
+    boot["setupMs"] = bootProfile.setupMs;
+    boot["settledMs"] = bootProfile.settledMs;
+    boot["heapAfterSetup"] = bootProfile.heapAfterSetup;
+    boot["network"] = networkStartupStateName();
+    JsonObject bootStages = boot.createNestedObject("stages");
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+      const BootStageTiming& timing = bootProfile.stages[i];
+      JsonObject stage = bootStages.createNestedObject(bootStageName(static_cast<BootStage>(i)));
+      stage["state"] = bootStageStateName(timing.state);
+      stage["startMs"] = timing.startMs;
+      stage["ms"] = timing.state == BOOT_RUNNING ? millis() - timing.startMs : timing.endMs - timing.startMs;
+    }
+    
     doc["wifi"] = WiFi.isConnected() ? "Connected (" + WiFi.localIP().toString() + ")" : "Disconnected";
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    JsonObject fetch = doc.createNestedObject("fetch");
+    fetch["inProgress"] = fetchStatus.inProgress;
+    fetch["feedsDone"] = fetchStatus.feedsDone;
+    fetch["feedsTotal"] = fetchStatus.feedsTotal;
+    fetch["succeeded"] = fetchStatus.succeeded;
+    fetch["failed"] = fetchStatus.failed;
+    fetch["deferred"] = fetchStatus.deferred;
+    fetch["headlines"] = fetchStatus.lastHeadlines;
+    fetch["cycles"] = fetchStatus.cycles;
+    fetch["collapsed"] = fetchStatus.collapsedRequests;
+    fetch["lastCycleMs"] = fetchStatus.lastCycleMs;
+    fetch["lastCycleAgo"] = fetchStatus.cycles ? (millis() - fetchStatus.lastCycleEnd) / 1000 : 0;
+    
+    JsonObject xml = doc.createNestedObject("xmlArena");
+    xml["bytes"] = fetchStatus.xmlArenaBytes;
+    xml["peakElements"] = fetchStatus.xmlPeakElements;
+    xml["peakAttributes"] = fetchStatus.xmlPeakAttributes;
+    xml["peakTexts"] = fetchStatus.xmlPeakTexts;
+    
+    MemorySnapshot mem = takeMemorySnapshot();
+    JsonObject memory = doc.createNestedObject("memory");
+    memory["largestBlock"] = mem.largestBlock;
+    memory["minFreeEver"] = ESP.getMinFreeHeap();
+    memory["freePsram"] = mem.freePsram;
+    JsonObject stages = memory.createNestedObject("stages");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+      if (memoryMetrics.stageMinFree[i] == UINT32_MAX) continue;
+      JsonObject stage = stages.createNestedObject(fetchStageName(static_cast<FetchStage>(i)));
+      stage["minFree"] = memoryMetrics.stageMinFree[i];
+      stage["minBlock"] = memoryMetrics.stageMinBlock[i];
+    }
+    JsonObject strategies = memory.createNestedObject("strategies");
+    for (int i = 0; i < STRATEGY_COUNT; i++) {
+      strategies[fetchStrategyName(static_cast<FetchStrategy>(i))] = memoryMetrics.strategyCount[i];
+    }
+    
+    // Heap per region, and how much of it the allocation policy placed there
+    static const uint32_t regionCaps[REGION_COUNT] = {
+      MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT
+    };
+    JsonObject regions = doc.createNestedObject("regions");
+    for (int i = 0; i < REGION_COUNT; i++) {
+      if (i == REGION_PSRAM && !psramFound()) continue;
+      const RegionUsage& usage = memPolicyStats.regions[i];
+      JsonObject region = regions.createNestedObject(memRegionName(static_cast<MemRegion>(i)));
+      region["total"] = heap_caps_get_total_size(regionCaps[i]);
+      region["free"] = heap_caps_get_free_size(regionCaps[i]);
+      region["largest"] = heap_caps_get_largest_free_block(regionCaps[i]);
+      region["policyBytes"] = usage.liveBytes;
+      region["policyPeak"] = usage.peakBytes;
+      region["allocs"] = usage.allocs;
+      region["failures"] = usage.failures;
+    }
+    JsonObject dma = regions.createNestedObject("dma");
+    dma["free"] = heap_caps_get_free_size(MALLOC_CAP_DMA);
+    dma["largest"] = heap_caps_get_largest_free_block(MALLOC_CAP_DMA);
+    regions["bulkFallbacks"] = memPolicyStats.bulkFallbacks;
+    
+    sendJson(request, std::move(doc));
+  });
+  
+  // Recent log output, oldest first
+  server.on("/log", HTTP_GET, [](AsyncWebServerRequest* request) {
+    request->send(200, "text/plain", logHistory());
+  });
+  
+  server.on("/log/level", HTTP_POST, [](AsyncWebServerRequest* request) {
+    if (!request->hasParam("module", true) || !request->hasParam("level", true)) {
+      request->send(400, "text/plain", "Missing module or level parameter");
+      return;
+    }
+    String module = request->getParam("module", true)->value();
+    int level = constrain(request->getParam("level", true)->value().toInt(), LOG_LEVEL_NONE, LOG_LEVEL_TRACE);
+    if (setLogLevel(module, level)) {
+      request->send(200, "text/plain", "Log level updated");
+    } else {
+      request->send(400, "text/plain", "Unknown log module");
+    }
   });
   
   // Time endpoints
@@ -53,84 +651,59 @@ void setupWebServer() {
   
   // Settings endpoints
   server.on("/settings", HTTP_GET, [](AsyncWebServerRequest* request) {
-    DynamicJsonDocument doc(1024);
-    doc["fetchInterval"] = settings.fetchInterval;
-    doc["maxNewsAgeHours"] = settings.maxNewsAgeHours;
-    doc["tzRegion"] = settings.tzRegion;
-    doc["maxHeadlinesPerFeed"] = settings.maxHeadlinesPerFeed;
+    lockSettings();
+    Settings current = settings;
+    unlockSettings();
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
-  });
-  
-  server.on("/settings", HTTP_POST, [](AsyncWebServerRequest* request) {
-    // Handle settings update
-    request->send(200, "text/plain", "Settings updated");
-  }, NULL, [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
     DynamicJsonDocument doc(1024);
-    deserializeJson(doc, data);
-    
-    settings.fetchInterval = doc["fetchInterval"] | settings.fetchInterval;
-    settings.maxNewsAgeHours = doc["maxNewsAgeHours"] | settings.maxNewsAgeHours;
-    settings.tzRegion = doc["tzRegion"] | settings.tzRegion;
-    settings.maxHeadlinesPerFeed = doc["maxHeadlinesPerFeed"] | settings.maxHeadlinesPerFeed;
+    doc["fetchInterval"] = current.fetchInterval;
+    doc["maxNewsAgeHours"] = current.maxNewsAgeHours;
+    doc["tzRegion"] = current.tzRegion;
+    doc["maxHeadlinesPerFeed"] = current.maxHeadlinesPerFeed;
+    doc["interleaveFeeds"] = current.interleaveFeeds;
+    doc["blockKeywords"] = current.blockKeywords;
+    doc["boostKeywords"] = current.boostKeywords;
+    doc["filterRules"] = keywordFilterRules();
     
-    loadConfiguration(); // Use loadConfiguration instead of saveConfiguration for now
-    applyTimezone();
+    sendJson(request, std::move(doc));
   });
   
+  onConfigPost("/settings", MAX_SETTINGS_BODY, false, applySettings, "Settings updated");
+  
   // RSS Feeds endpoints
   server.on("/feeds", HTTP_GET, [](AsyncWebServerRequest* request) {
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    JsonArray array = doc.to<JsonArray>();
-    
-    for (const auto& feed : feeds) {
-      JsonObject obj = array.createNestedObject();
-      obj["name"] = feed.name;
-      obj["url"] = feed.url;
-      obj["enabled"] = feed.enabled;
-    }
-    
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    // Built one feed per chunk, so any number of feeds fits
+    sendFeedsJson(request);
   });
   
-  server.on("/feeds", HTTP_POST, [](AsyncWebServerRequest* request) {
-    request->send(200, "text/plain", "Feeds updated");
-  }, NULL, [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-    DynamicJsonDocument doc(JSON_BUFFER_SIZE);
-    deserializeJson(doc, data);
-    
-    feeds.clear();
-    JsonArray array = doc.as<JsonArray>();
-    
-    for (JsonObject obj : array) {
-      RSSFeed feed;
-      feed.name = obj["name"].as<String>();
-      feed.url = obj["url"].as<String>();
-      feed.enabled = obj["enabled"].as<bool>();
-      feeds.push_back(feed);
-    }
-    
-    saveFeedsToFile();
-  });
+  // Feed lists can be long, so their bodies may go to PSRAM
+  onConfigPost("/feeds", MAX_FEEDS_BODY, true, applyFeeds, "Feeds updated");
+  
+  // One feed at a time, by id
+  setupFeedRoutes();
   
   server.on("/feeds/reset", HTTP_POST, [](AsyncWebServerRequest* request) {
+    lockFeeds();
     initializeDefaultFeeds();
+    feedListVersion++;
+    unlockFeeds();
+    clearRSSHeadlines();
+    resetDedup();
     saveFeedsToFile();
+    requestRSSFetch();
     request->send(200, "text/plain", "Feeds reset to default");
   });
   
   server.begin();
-  Serial.println("Web server started");
+  LOG_INFO(WEB, "Web server started\n");
 }
 
 void setupOTARoutes() {
   // OTA Update page
   server.on("/update", HTTP_GET, [](AsyncWebServerRequest* request) {
-    request->send(SPIFFS, "/update.html", "text/html");
+    if (!sendWebAsset(request, "/update.html")) {
+      request->send(SPIFFS, "/update.html", "text/html");
+    }
   });
   
   // Handle firmware upload
@@ -142,13 +715,17 @@ void setupOTARoutes() {
     request->send(response);
     
     if (shouldReboot) {
+      // Don't lose config changes still waiting out their debounce
+      if (!flushConfigStore()) {
+        LOG_WARN(WEB, "Config store: unsaved changes will be lost on restart\n");
+      }
       delay(1000);
       ESP.restart();
     }
   }, [](AsyncWebServerRequest* request, String filename, size_t index, uint8_t* data, size_t len, bool final) {
     // Handle file upload
     if (!index) {
-      Serial.printf("Update Start: %s\n", filename.c_str());
+      LOG_INFO(WEB, "Update Start: %s\n", filename.c_str());
       
       // Start update process
       if (!Update.begin(UPDATE_SIZE_UNKNOWN)) {
@@ -166,7 +743,7 @@ void setupOTARoutes() {
     // Final chunk
     if (final) {
       if (Update.end(true)) {
-        Serial.printf("Update Success: %uB\n", index + len);
+        LOG_INFO(WEB, "Update Success: %uB\n", index + len);
       } else {
         Update.printError(Serial);
       }
@@ -189,86 +766,28 @@ void setupDisplayRoutes() {
     doc["secondaryColor"] = displaySettings.secondaryColor;
     doc["scrollEnabled"] = displaySettings.scrollEnabled;
     doc["animationEnabled"] = displaySettings.animationEnabled;
+    doc["marqueeMode"] = displaySettings.marqueeMode;
+    doc["layout"] = displaySettings.layout;
+    doc["previewFps"] = displaySettings.previewFps;
     
-    String response;
-    serializeJson(doc, response);
-    request->send(200, "application/json", response);
+    sendJson(request, std::move(doc));
   });
   
-  server.on("/display/settings", HTTP_POST, [](AsyncWebServerRequest* request) {
-    request->send(200, "text/plain", "Display settings updated");
-  }, NULL, [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-    DynamicJsonDocument doc(1024);
-    deserializeJson(doc, data);
-    
-    if (doc.containsKey("brightness")) {
-      setDisplayBrightness(doc["brightness"]);
-    }
-    if (doc.containsKey("scrollSpeed")) {
-      setScrollSpeed(doc["scrollSpeed"]);
-    }
-    if (doc.containsKey("scrollDirection")) {
-      setScrollDirection(doc["scrollDirection"]);
-    }
-    if (doc.containsKey("panelType")) {
-      setPanelType(static_cast<PanelType>(doc["panelType"].as<int>()));
-    }
-    if (doc.containsKey("fontType")) {
-      setFontType(static_cast<FontType>(doc["fontType"].as<int>()));
-    }
-    if (doc.containsKey("animationType")) {
-      setAnimationType(static_cast<AnimationType>(doc["animationType"].as<int>()));
-    }
-    if (doc.containsKey("animationEnabled")) {
-      displaySettings.animationEnabled = doc["animationEnabled"];
-    }
-    
-    saveDisplaySettings();
-  });
+  onConfigPost("/display/settings", MAX_SETTINGS_BODY, false, applyDisplaySettings, "Display settings updated");
   
   // Scroll content endpoint
-  server.on("/display/content", HTTP_POST, [](AsyncWebServerRequest* request) {
-    request->send(200, "text/plain", "Scroll content updated");
-  }, NULL, [](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
-    DynamicJsonDocument doc(1024);
-    deserializeJson(doc, data);
-    
-    // Update scroll content enable/disable status
-    for (auto& content : scrollContents) {
-      switch (content.type) {
-        case CONTENT_TIME:
-          content.enabled = doc["time"] | content.enabled;
-          break;
-        case CONTENT_DATE:
-          content.enabled = doc["date"] | content.enabled;
-          break;
-        case CONTENT_RSS_FEEDS:
-          content.enabled = doc["rss"] | content.enabled;
-          break;
-        case CONTENT_QUOTE_OF_DAY:
-          content.enabled = doc["quotes"] | content.enabled;
-          break;
-        case CONTENT_FUN_FACTS:
-          content.enabled = doc["facts"] | content.enabled;
-          break;
-      }
-    }
-    
-    saveDisplaySettings();
-  });
+  onConfigPost("/display/content", MAX_SETTINGS_BODY, false, applyDisplayContent, "Scroll content updated",
+               checkDisplayContent);
   
   // Manual RSS fetch trigger
   server.on("/feeds/fetch", HTTP_POST, [](AsyncWebServerRequest* request) {
-    Serial.println("RSS fetch requested via web interface");
-    
-    // Create a task to fetch RSS feeds to avoid blocking the web server
-    xTaskCreate([](void* parameter) {
-      Serial.println("Starting RSS fetch task...");
-      fetchAllRSSFeeds();
-      Serial.println("RSS fetch task completed");
-      vTaskDelete(NULL);
-    }, "RSS_Fetch_Task", 8192, NULL, 1, NULL);
+    LOG_INFO(WEB, "RSS fetch requested via web interface\n");
     
-    request->send(200, "text/plain", "RSS fetch started");
+    // The fetcher task owns the network; just ask it for a cycle
+    if (requestRSSFetch()) {
+      request->send(202, "text/plain", "RSS fetch started");
+    } else {
+      request->send(200, "text/plain", "RSS fetch already in progress");
+    }
   });
 }
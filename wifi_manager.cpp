@@ -1,46 +1,139 @@
 
 #include "wifi_manager.h"
+#include "time_manager.h"
+#include "rss_handler.h"
+#include "boot_profile.h"
 
-bool connectToWiFi() {
+// Network startup runs on its own task so the panel and web UI are up
+// while Wi-Fi associates and NTP answers. Each step below is quick
+// except the internet probe, which only holds up this task.
+enum NetStartupState : uint8_t {
+  NET_CONNECTING = 0,
+  NET_PROBING,
+  NET_ONLINE,     // waiting for NTP and the first fetch
+  NET_OFFLINE,    // no Wi-Fi or no internet; AP mode if no Wi-Fi
+  NET_DONE
+};
+
+static const char* const netStateNames[] = {"connecting", "probing", "online", "offline", "done"};
+static volatile NetStartupState netState = NET_DONE;
+static unsigned long netStateSince = 0;
+static bool firstFetchRequested = false;
+
+static void enterNetState(NetStartupState state) {
+  netState = state;
+  netStateSince = millis();
+}
+
+static void requestFirstFetch() {
+  firstFetchRequested = true;
+  bootStageBegin(BOOT_FIRST_FETCH);
+  lastFetchTime = millis();  // the periodic schedule counts from here
+  requestRSSFetch();
+}
+
+// Advances the startup sequence by one step
+static void stepNetworkStartup() {
+  unsigned long elapsed = millis() - netStateSince;
+  
+  switch (netState) {
+    case NET_CONNECTING:
+      if (WiFi.status() == WL_CONNECTED) {
+        Serial.printf("Wi-Fi connected successfully!\n");
+        Serial.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
+        Serial.printf("Signal Strength: %d dBm\n", WiFi.RSSI());
+        bootStageEnd(BOOT_WIFI, true);
+        bootStageBegin(BOOT_INTERNET);
+        enterNetState(NET_PROBING);
+      } else if (elapsed > WIFI_CONNECT_TIMEOUT_MS) {
+        Serial.println("Wi-Fi connection failed - starting AP mode");
+        bootStageEnd(BOOT_WIFI, false);
+        startAccessPoint();
+        enterNetState(NET_OFFLINE);
+      }
+      break;
+      
+    case NET_PROBING:
+      hasInternet = isConnectedToInternet();
+      bootStageEnd(BOOT_INTERNET, hasInternet);
+      if (!hasInternet) {
+        Serial.println("Wi-Fi connected but no internet access");
+        enterNetState(NET_OFFLINE);
+        break;
+      }
+      Serial.println("Internet connectivity confirmed");
+      bootStageBegin(BOOT_NTP);
+      beginNTPSync();
+      // With the RTC's time, feed ages can be judged already, so the
+      // first fetch runs alongside NTP
+      if (clockIsSet()) requestFirstFetch();
+      enterNetState(NET_ONLINE);
+      break;
+      
+    case NET_ONLINE:
+      if (bootProfile.stages[BOOT_NTP].state == BOOT_RUNNING) {
+        if (ntpSyncDone()) {
+          bootStageEnd(BOOT_NTP, true);
+        } else if (elapsed > NTP_SYNC_TIMEOUT_MS) {
+          Serial.println("NTP sync timed out - keeping RTC time");
+          bootStageEnd(BOOT_NTP, false);
+        }
+      }
+      if (!firstFetchRequested && bootProfile.stages[BOOT_NTP].state != BOOT_RUNNING) {
+        requestFirstFetch();
+      }
+      if (bootProfile.stages[BOOT_FIRST_FETCH].state == BOOT_RUNNING && fetchStatus.cycles > 0) {
+        bootStageEnd(BOOT_FIRST_FETCH, fetchStatus.lastHeadlines > 0);
+      }
+      if (bootProfile.stages[BOOT_NTP].state != BOOT_RUNNING &&
+          bootProfile.stages[BOOT_FIRST_FETCH].state != BOOT_RUNNING) {
+        enterNetState(NET_DONE);
+      }
+      break;
+      
+    case NET_OFFLINE:
+      bootStageSkip(BOOT_INTERNET);
+      bootStageSkip(BOOT_NTP);
+      bootStageSkip(BOOT_FIRST_FETCH);
+      enterNetState(NET_DONE);
+      break;
+      
+    case NET_DONE:
+      break;
+  }
+}
+
+static void networkStartupTask(void* parameter) {
+  while (netState != NET_DONE) {
+    stepNetworkStartup();
+    vTaskDelay(pdMS_TO_TICKS(NET_STARTUP_TICK_MS));
+  }
+  vTaskDelete(NULL);
+}
+
+void startNetwork() {
+  bootStageBegin(BOOT_WIFI);
   String ssid = preferences.getString("ssid", "");
   String pass = preferences.getString("pass", "");
   
   if (ssid.length() == 0) {
     Serial.println("No Wi-Fi credentials stored");
+    bootStageEnd(BOOT_WIFI, false);
     startAccessPoint();
-    return false;
-  }
-  
-  Serial.printf("Connecting to Wi-Fi: %s\n", ssid.c_str());
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(ssid.c_str(), pass.c_str());
-  
-  unsigned long startTime = millis();
-  const unsigned long timeout = 15000; // 15 seconds
-  
-  while (WiFi.status() != WL_CONNECTED && (millis() - startTime) < timeout) {
-    delay(500);
-    Serial.print(".");
-  }
-  
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.printf("\nWi-Fi connected successfully!\n");
-    Serial.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
-    Serial.printf("Signal Strength: %d dBm\n", WiFi.RSSI());
-    
-    // Test internet connectivity
-    if (isConnectedToInternet()) {
-      Serial.println("Internet connectivity confirmed");
-      return true;
-    } else {
-      Serial.println("Wi-Fi connected but no internet access");
-      return false;
-    }
+    enterNetState(NET_OFFLINE);
+  } else {
+    Serial.printf("Connecting to Wi-Fi: %s\n", ssid.c_str());
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(ssid.c_str(), pass.c_str());
+    enterNetState(NET_CONNECTING);
   }
   
-  Serial.println("\nWi-Fi connection failed - starting AP mode");
-  startAccessPoint();
-  return false;
+  // HTTPClient for the internet probe needs the larger stack
+  xTaskCreate(networkStartupTask, "Net_Startup", 6144, NULL, 1, NULL);
+}
+
+const char* networkStartupStateName() {
+  return netStateNames[netState];
 }
 
 void startAccessPoint() {
@@ -4,8 +4,13 @@
 
 #include "config.h"
 
+#define WIFI_CONNECT_TIMEOUT_MS 15000
+#define NTP_SYNC_TIMEOUT_MS 10000   // after that the RTC's time stands
+#define NET_STARTUP_TICK_MS 100
+
 // Function declarations
-bool connectToWiFi();
+void startNetwork();  // starts Wi-Fi and returns; the rest runs on a task
+const char* networkStartupStateName();
 void startAccessPoint();
 void setupWiFiRoutes();
 bool isConnectedToInternet();